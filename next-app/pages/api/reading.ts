@@ -1,6 +1,6 @@
 import { NextApiRequest, NextApiResponse } from 'next'
 import db from '../../lib/db'
-import { ReadingsFromAP } from '../../schemas/Reading'
+import { ReadingsFromAPBatch } from '../../schemas/Reading'
 
 export default async function handler(req: NextApiRequest, res: NextApiResponse) {
     const { method } = req
@@ -8,7 +8,7 @@ export default async function handler(req: NextApiRequest, res: NextApiResponse)
     switch (method) {
         case 'POST':
             try {
-                const response = ReadingsFromAP.safeParse(req.body)
+                const response = ReadingsFromAPBatch.safeParse(req.body)
 
                 if (!response.success) {
                     const { errors } = response.error
@@ -18,14 +18,17 @@ export default async function handler(req: NextApiRequest, res: NextApiResponse)
                     })
                 }
                 
-                const readings = response.data.sensors.flatMap((sensor, sensor_index) => sensor.pdr.map((pdr, index) => ({
-                    ap: response.data.ap,
-                    name: response.data.sensors[sensor_index].name,
+                // the simulator posts batches, single reports are still accepted
+                const reports = Array.isArray(response.data) ? response.data : [response.data]
+
+                const readings = reports.flatMap((report) => report.sensors.flatMap((sensor) => sensor.pdr.map((pdr, index) => ({
+                    ap: report.ap,
+                    name: sensor.name,
                     pdr: pdr,
-                    rssi: response.data.sensors[sensor_index].rssi[index],
-                    at: response.data.at+index,
-                    _id: response.data.ap + response.data.sensors[sensor_index].name + (response.data.at+index)
-                })))
+                    rssi: sensor.rssi[index],
+                    at: report.at+index,
+                    _id: report.ap + sensor.name + (report.at+index)
+                }))))
 
                 db.bulkDocs(readings)
 
@@ -12,4 +12,6 @@ const ReadingsFromAP = z.object({
     sensors: z.array(Reading)
 })
 
-export { Reading, ReadingsFromAP }
+const ReadingsFromAPBatch = z.union([ReadingsFromAP, z.array(ReadingsFromAP)])
+
+export { Reading, ReadingsFromAP, ReadingsFromAPBatch }
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+// Wire format benchmark for AP reports: encoded size, encode and decode time
+// per report for JSON, CBOR and MessagePack, and what the size means on the
+// 1 Mbps DSSS links of the wifi cells (airtime of the payload alone and
+// number of TCP segments at the default 536 byte segment size).
+//
+//   ./waf --run "iotnet-codec-benchmark"
+//   ./waf --run "iotnet-codec-benchmark --sensors=1,20,200 --iterations=10000"
+
+#include "nlohmann/json.hpp"
+
+#include "ns3/core-module.h"
+#include "ns3/iotnet-codec.h"
+
+#include <chrono>
+#include <cmath>
+
+using namespace ns3;
+using json = nlohmann::json;
+
+static json
+Report (uint32_t sensors)
+{
+  // same shape as IoTNetWifi::GatherInformation
+  json payload;
+  payload["ap"] = "wifi-phong-bep";
+  payload["at"] = int64_t (1700000000000);
+  payload["sensors"] = json::array ();
+  for (uint32_t i = 0; i < sensors; i++)
+    {
+      double rss = -60.0 - 0.37 * i;
+      payload["sensors"].push_back ({{"name", "sensor-" + std::to_string (i)},
+                                     {"rssi", {-200 - rss}},
+                                     {"pdr", {std::pow (rss / 154, 2)}}});
+    }
+  return payload;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string sensorList = "1,10,50,200";
+  uint32_t iterations = 2000;
+  uint32_t segmentSize = 536;
+
+  CommandLine cmd;
+  cmd.AddValue ("sensors", "Comma separated sensors per report", sensorList);
+  cmd.AddValue ("iterations", "Reports encoded and decoded per measurement", iterations);
+  cmd.AddValue ("segmentSize", "TCP segment size in bytes", segmentSize);
+  cmd.Parse (argc, argv);
+
+  typedef std::chrono::steady_clock Clock;
+  const IoTNetCodec::Format formats[] = {IoTNetCodec::JSON, IoTNetCodec::CBOR, IoTNetCodec::MSGPACK};
+
+  std::cout << "sensors,format,bytes,ratio,encode_us,decode_us,airtime_ms,segments" << std::endl;
+
+  std::stringstream list (sensorList);
+  std::string item;
+  while (std::getline (list, item, ','))
+    {
+      uint32_t sensors = std::stoul (item);
+      json report = Report (sensors);
+      size_t jsonBytes = report.dump ().size ();
+
+      for (IoTNetCodec::Format format : formats)
+        {
+          std::string bytes;
+          Clock::time_point start = Clock::now ();
+          for (uint32_t i = 0; i < iterations; i++)
+            {
+              bytes = IoTNetCodec::Encode (report, format);
+            }
+          Clock::time_point encoded = Clock::now ();
+
+          // the server path: decode and turn back into JSON text for the sinks
+          std::string text;
+          for (uint32_t i = 0; i < iterations; i++)
+            {
+              IoTNetCodec::ToJson (reinterpret_cast<const uint8_t *> (bytes.data ()), bytes.size (), format, text);
+            }
+          Clock::time_point decoded = Clock::now ();
+
+          NS_ABORT_MSG_UNLESS (json::parse (text) == report, "round trip changed the report");
+
+          double encodeUs = std::chrono::duration<double, std::micro> (encoded - start).count () / iterations;
+          double decodeUs = std::chrono::duration<double, std::micro> (decoded - encoded).count () / iterations;
+          std::cout << sensors << ","
+                    << IoTNetCodec::GetName (format) << ","
+                    << bytes.size () << ","
+                    << double (bytes.size ()) / jsonBytes << ","
+                    << encodeUs << ","
+                    << decodeUs << ","
+                    << bytes.size () * 8 / 1000.0 << ","
+                    << (bytes.size () + segmentSize - 1) / segmentSize << std::endl;
+        }
+    }
+  return 0;
+}
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+// Scalability benchmark: builds generated topologies of growing size and
+// reports setup time, simulated events per wall clock second and the peak
+// resident set size. Each size and routing mode runs in its own forked
+// process so the peak RSS of one run does not hide the next one. routes_s
+// times route installation alone, comparing the static tree routes against
+// Ipv4GlobalRoutingHelper; install_s covers the rest of IoTNet::Install.
+//
+//   ./waf --run "iotnet-scalability"                    # 100, 1k and 10k nodes
+//   ./waf --run "iotnet-scalability --nodes=5000"       # one size
+//   ./waf --run "iotnet-scalability --sizes=100,500"    # custom sizes
+//   ./waf --run "iotnet-scalability --routing=tree"     # tree, global or both
+
+#include "ns3/core-module.h"
+#include "ns3/iotnet-helper.h"
+#include "ns3/iotnet-scenario.h"
+
+#include <chrono>
+#include <cmath>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+static double
+PeakRssMb (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0; // kilobytes on Linux
+}
+
+static void
+Benchmark (uint32_t nodes, uint32_t sensors, uint32_t rooms, double duration, bool globalRouting)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  // nodes = server + router + cells * (ap + sensors)
+  uint32_t cells = std::max<uint32_t> (1, std::ceil ((nodes - 2) / double (sensors + 1)));
+  uint32_t buildings = std::max<uint32_t> (1, std::ceil (cells / double (rooms)));
+  rooms = std::ceil (cells / double (buildings));
+
+  Clock::time_point start = Clock::now ();
+
+  IoTNet::world = CreateObject<IoTNet> ();
+  IoTNet::world->globalRouting = globalRouting;
+  IoTNetHelper helper;
+  Ptr<IoTNetScenario> scenario = CreateObject<IoTNetScenario> (helper.Generate (buildings, rooms, sensors));
+  scenario->Build ();
+  Clock::time_point built = Clock::now ();
+
+  IoTNet::world->InstallRoutes ();
+  Clock::time_point routed = Clock::now ();
+
+  IoTNet::world->InstallMobility ();
+  Clock::time_point installed = Clock::now ();
+
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  Clock::time_point finished = Clock::now ();
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+
+  double buildSeconds = std::chrono::duration<double> (built - start).count ();
+  double routeSeconds = std::chrono::duration<double> (routed - built).count ();
+  double installSeconds = std::chrono::duration<double> (installed - routed).count ();
+  double runSeconds = std::chrono::duration<double> (finished - installed).count ();
+
+  std::cout << NodeList::GetNNodes () << ","
+            << buildings << "x" << rooms << "x" << sensors << ","
+            << (globalRouting ? "global" : "tree") << ","
+            << buildSeconds << ","
+            << routeSeconds << ","
+            << installSeconds << ","
+            << events << ","
+            << events / runSeconds << ","
+            << PeakRssMb () << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nodes = 0;
+  std::string sizes = "100,1000,10000";
+  uint32_t sensors = 9;
+  uint32_t rooms = 10;
+  double duration = 30;
+  std::string routing = "both";
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "Benchmark one size, 0 for all of sizes", nodes);
+  cmd.AddValue ("sizes", "Comma separated node counts", sizes);
+  cmd.AddValue ("sensors", "Sensors per room", sensors);
+  cmd.AddValue ("rooms", "Rooms per building", rooms);
+  cmd.AddValue ("duration", "Simulated seconds", duration);
+  cmd.AddValue ("routing", "Routing setup: tree, global or both", routing);
+  cmd.Parse (argc, argv);
+
+  std::cout << "nodes,layout,routing,build_s,routes_s,install_s,events,events_per_s,peak_rss_mb" << std::endl;
+
+  std::vector<bool> modes;
+  if (routing == "tree" || routing == "both")
+    {
+      modes.push_back (false);
+    }
+  if (routing == "global" || routing == "both")
+    {
+      modes.push_back (true);
+    }
+  NS_ABORT_MSG_IF (modes.empty (), "Unknown routing " << routing);
+
+  if (nodes > 0 && modes.size () == 1)
+    {
+      Benchmark (nodes, sensors, rooms, duration, modes[0]);
+      return 0;
+    }
+
+  std::vector<std::string> list;
+  if (nodes > 0)
+    {
+      list.push_back (std::to_string (nodes));
+    }
+  else
+    {
+      std::stringstream ss (sizes);
+      std::string size;
+      while (std::getline (ss, size, ','))
+        {
+          list.push_back (size);
+        }
+    }
+
+  for (const std::string &size : list)
+    {
+      for (bool globalRouting : modes)
+        {
+          std::cout.flush ();
+          pid_t child = fork ();
+          if (child == 0)
+            {
+              Benchmark (std::stoul (size), sensors, rooms, duration, globalRouting);
+              _exit (0);
+            }
+          int status;
+          waitpid (child, &status, 0);
+          if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+            {
+              std::cout << size << ",," << (globalRouting ? "global" : "tree") << ",failed" << std::endl;
+            }
+        }
+    }
+  return 0;
+}
@@ -2,6 +2,71 @@
 
 #include "iotnet-helper.h"
 
+#include <cmath>
+
 namespace ns3
 {
+  IoTNetHelper::IoTNetHelper()
+      : roomNetwork("10.16.0.0"),
+        buildingSpacing(200.0),
+        roomSpacing(20.0),
+        sensorRadius(5.0)
+  {
+  }
+
+  Ipv4Address IoTNetHelper::Subnet(Ipv4Address base, Ipv4Mask mask, uint32_t index)
+  {
+    uint64_t size = uint64_t(~mask.Get()) + 1;
+    uint64_t network = uint64_t(base.Get() & mask.Get()) + size * index;
+    NS_ABORT_MSG_IF(network > 0xffffffff, "IoTNetHelper: subnet " << index << " of " << base << " is out of range");
+    return Ipv4Address(uint32_t(network));
+  }
+
+  IoTNetScenario::Description IoTNetHelper::Generate(uint32_t buildings, uint32_t rooms, uint32_t sensors) const
+  {
+    NS_ABORT_MSG_IF(sensors > 253, "IoTNetHelper: at most 253 sensors fit in a room subnet");
+    NS_ABORT_MSG_IF(uint64_t(buildings) * rooms > (0xffffffff - roomNetwork.Get()) / 256 + 1,
+                    "IoTNetHelper: " << buildings * rooms << " rooms do not fit after " << roomNetwork);
+
+    IoTNetScenario::Description description;
+    std::stringstream name;
+    name << buildings << "x" << rooms << "x" << sensors;
+    description.name = name.str();
+
+    double width = buildingSpacing * (buildings - 1);
+    description.server = {"server", "10.1.1.0", "255.255.255.0", Vector(width / 2, -20.0, 0.0)};
+    description.router = {"router", "10.2.0.0", "255.255.255.252", Vector(width / 2, -10.0, 0.0)};
+
+    uint32_t columns = std::ceil(std::sqrt(rooms));
+    for (uint32_t b = 0; b < buildings; b++)
+    {
+      for (uint32_t r = 0; r < rooms; r++)
+      {
+        IoTNetScenario::Cell cell;
+        std::stringstream id;
+        id << "wifi-b" << b << "-r" << r;
+        cell.id = id.str();
+        cell.network = Subnet(roomNetwork, Ipv4Mask("255.255.255.0"), b * rooms + r);
+        cell.mask = Ipv4Mask("255.255.255.0");
+        cell.position = Vector(b * buildingSpacing + (r % columns) * roomSpacing, (r / columns) * roomSpacing, 0.0);
+
+        for (uint32_t s = 0; s < sensors; s++)
+        {
+          std::stringstream sensor;
+          sensor << "b" << b << "-r" << r << "-s" << s;
+          double angle = 2 * M_PI * s / sensors;
+          cell.sensors.push_back({sensor.str(), Vector(cell.position.x + sensorRadius * std::cos(angle),
+                                                       cell.position.y + sensorRadius * std::sin(angle),
+                                                       0.0)});
+        }
+
+        description.links.push_back(cell.id);
+        description.wifi.push_back(cell);
+      }
+    }
+
+    description.sender = description.server.id;
+    description.receiver = description.wifi.empty() ? "" : description.wifi.front().id;
+    return description;
+  }
 }
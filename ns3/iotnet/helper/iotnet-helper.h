@@ -3,9 +3,37 @@
 #define IOTNET_HELPER_H
 
 #include "ns3/iotnet.h"
+#include "ns3/iotnet-scenario.h"
 
 namespace ns3
 {
+  /**
+   * Generates large regular topologies: buildings x rooms x sensors. Every
+   * room is one wifi cell with its AP in the middle and the sensors on a
+   * circle around it, rooms are laid out on a square grid inside their
+   * building and buildings are lined up along the x axis.
+   *
+   * Room subnets are /24 networks counted up from roomNetwork, carrying into
+   * the next octet after x.y.255.0, so 10.16.0.0 leaves room for 61440 rooms
+   * of at most 253 sensors. The router links are /30 networks from 10.2.0.0.
+   */
+  class IoTNetHelper
+  {
+  public:
+    IoTNetHelper();
+
+    IoTNetScenario::Description Generate(uint32_t buildings, uint32_t rooms, uint32_t sensors) const;
+
+    /**
+     * \returns the index-th network of the given size after base.
+     */
+    static Ipv4Address Subnet(Ipv4Address base, Ipv4Mask mask, uint32_t index);
+
+    Ipv4Address roomNetwork;
+    double buildingSpacing; // meters between buildings
+    double roomSpacing;     // meters between rooms of one building
+    double sensorRadius;    // meters between a sensor and its AP
+  };
 }
 
 #endif /* IOTNET_HELPER_H */
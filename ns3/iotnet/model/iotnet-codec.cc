@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "nlohmann/json.hpp"
+
+#include "iotnet-codec.h"
+
+using json = nlohmann::json;
+
+namespace ns3
+{
+  IoTNetCodec::Format IoTNetCodec::FromName(const std::string name)
+  {
+    if (name == "json")
+    {
+      return JSON;
+    }
+    if (name == "cbor")
+    {
+      return CBOR;
+    }
+    if (name == "msgpack")
+    {
+      return MSGPACK;
+    }
+    NS_FATAL_ERROR("Unknown wire format " << name);
+  }
+
+  std::string IoTNetCodec::GetName(Format format)
+  {
+    switch (format)
+    {
+    case CBOR:
+      return "cbor";
+    case MSGPACK:
+      return "msgpack";
+    default:
+      return "json";
+    }
+  }
+
+  std::string IoTNetCodec::Encode(const json &document, Format format)
+  {
+    std::string bytes;
+    switch (format)
+    {
+    case CBOR:
+      json::to_cbor(document, bytes);
+      break;
+    case MSGPACK:
+      json::to_msgpack(document, bytes);
+      break;
+    default:
+      bytes = document.dump();
+      break;
+    }
+    return bytes;
+  }
+
+  json IoTNetCodec::Decode(const uint8_t *data, size_t size, Format format)
+  {
+    try
+    {
+      switch (format)
+      {
+      case CBOR:
+        return json::from_cbor(data, data + size);
+      case MSGPACK:
+        return json::from_msgpack(data, data + size);
+      default:
+        return json::parse(data, data + size, nullptr, false);
+      }
+    }
+    catch (const json::exception &)
+    {
+      return json(json::value_t::discarded);
+    }
+  }
+
+  bool IoTNetCodec::ToJson(const uint8_t *data, size_t size, Format format, std::string &text)
+  {
+    if (format == JSON)
+    {
+      text.assign(reinterpret_cast<const char *>(data), size);
+      return true;
+    }
+
+    json document = Decode(data, size, format);
+    if (document.is_discarded())
+    {
+      return false;
+    }
+    text = document.dump();
+    return true;
+  }
+}
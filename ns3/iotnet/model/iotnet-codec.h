@@ -0,0 +1,50 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef IOTNET_CODEC_H
+#define IOTNET_CODEC_H
+
+#include "ns3/core-module.h"
+
+#include "nlohmann/json_fwd.hpp"
+
+namespace ns3
+{
+  /**
+   * Wire format of the AP -> server reports. JSON is text, CBOR and
+   * MessagePack are the binary encodings of the same document provided by
+   * nlohmann::json, typically a third smaller. Sinks always receive JSON
+   * text, the server converts binary reports back before forwarding.
+   */
+  class IoTNetCodec
+  {
+  public:
+    enum Format
+    {
+      JSON = 0,
+      CBOR,
+      MSGPACK
+    };
+
+    /**
+     * \returns the format called name ("json", "cbor" or "msgpack"), aborts
+     * on anything else.
+     */
+    static Format FromName(const std::string name);
+    static std::string GetName(Format format);
+
+    static std::string Encode(const nlohmann::json &document, Format format);
+
+    /**
+     * Decode one report. Invalid input yields a discarded value
+     * (nlohmann::json::is_discarded()).
+     */
+    static nlohmann::json Decode(const uint8_t *data, size_t size, Format format);
+
+    /**
+     * Convert one report to JSON text, JSON input is returned as is.
+     * \returns false if the report cannot be decoded.
+     */
+    static bool ToJson(const uint8_t *data, size_t size, Format format, std::string &text);
+  };
+}
+
+#endif /* IOTNET_CODEC_H */
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "iotnet-connection.h"
+#include "iotnet-frame-buffer.h"
+
+namespace ns3
+{
+  IoTNetConnection::IoTNetConnection(Ptr<Node> node, Address peer, bool udp, uint32_t maxQueue,
+                                     Time initialBackoff, Time maxBackoff)
+      : m_node(node),
+        m_peer(peer),
+        m_udp(udp),
+        m_maxQueue(maxQueue),
+        m_initialBackoff(initialBackoff),
+        m_maxBackoff(maxBackoff),
+        m_state(IDLE),
+        m_offset(0),
+        m_backoff(initialBackoff),
+        m_sent(0),
+        m_dropped(0),
+        m_connects(0)
+  {
+  }
+
+  IoTNetConnection::~IoTNetConnection()
+  {
+    Close();
+  }
+
+  void IoTNetConnection::Send(std::string message)
+  {
+    uint32_t frameSize = IoTNetFrameBuffer::headerSize + message.size();
+    if (message.size() > IoTNetFrameBuffer::defaultMaxFrameSize || (m_udp && frameSize > maxDatagramSize))
+    {
+      // the server closes the stream on it and Fail() would resend it forever
+      m_dropped++;
+      return;
+    }
+
+    if (m_queue.size() >= m_maxQueue)
+    {
+      m_dropped++;
+      if (m_offset > 0 && m_queue.size() == 1)
+      {
+        // the only queued frame is half written, it has to finish first
+        return;
+      }
+      // the oldest reading is the least useful one, unless it is half written
+      m_queue.erase(m_offset > 0 ? m_queue.begin() + 1 : m_queue.begin());
+    }
+    m_queue.push_back(IoTNetFrameBuffer::Frame(message));
+
+    if (m_state == IDLE && !m_reconnectEvent.IsRunning())
+    {
+      Connect();
+    }
+    if (m_state == CONNECTED)
+    {
+      Flush();
+    }
+  }
+
+  void IoTNetConnection::Close()
+  {
+    Simulator::Cancel(m_reconnectEvent);
+    if (m_socket)
+    {
+      m_socket->SetConnectCallback(MakeNullCallback<void, Ptr<Socket>>(), MakeNullCallback<void, Ptr<Socket>>());
+      m_socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket>>(), MakeNullCallback<void, Ptr<Socket>>());
+      m_socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+      m_socket->Close();
+      m_socket = nullptr;
+    }
+    // the peer discards a partial frame with the connection
+    m_offset = 0;
+    m_state = IDLE;
+  }
+
+  IoTNetConnection::State IoTNetConnection::GetState() const
+  {
+    return m_state;
+  }
+
+  uint32_t IoTNetConnection::GetQueued() const
+  {
+    return m_queue.size();
+  }
+
+  uint64_t IoTNetConnection::GetSent() const
+  {
+    return m_sent;
+  }
+
+  uint64_t IoTNetConnection::GetDropped() const
+  {
+    return m_dropped;
+  }
+
+  uint32_t IoTNetConnection::GetConnects() const
+  {
+    return m_connects;
+  }
+
+  void IoTNetConnection::Connect()
+  {
+    if (m_udp)
+    {
+      // datagrams need no handshake, the socket is usable right away
+      m_socket = Socket::CreateSocket(m_node, UdpSocketFactory::GetTypeId());
+      m_socket->Bind();
+      m_socket->Connect(m_peer);
+      m_state = CONNECTED;
+      m_connects++;
+      return;
+    }
+
+    m_socket = Socket::CreateSocket(m_node, TcpSocketFactory::GetTypeId());
+    m_socket->SetConnectCallback(MakeCallback(&IoTNetConnection::ConnectionSucceeded, this),
+                                 MakeCallback(&IoTNetConnection::ConnectionFailed, this));
+    m_socket->SetCloseCallbacks(MakeCallback(&IoTNetConnection::NormalClose, this),
+                                MakeCallback(&IoTNetConnection::ErrorClose, this));
+    m_socket->SetSendCallback(MakeCallback(&IoTNetConnection::SendSpace, this));
+    m_socket->Bind();
+    m_state = CONNECTING;
+    m_socket->Connect(m_peer);
+  }
+
+  void IoTNetConnection::Flush()
+  {
+    while (m_state == CONNECTED && !m_queue.empty())
+    {
+      const std::string &message = m_queue.front();
+      uint32_t size = message.length() - m_offset;
+      if (!m_udp)
+      {
+        // frames larger than the send buffer go out in pieces, SendSpace()
+        // resumes once the peer acknowledged enough data
+        size = std::min(size, m_socket->GetTxAvailable());
+        if (size == 0)
+        {
+          return;
+        }
+      }
+
+      Ptr<Packet> packet = Create<Packet>((uint8_t *)message.c_str() + m_offset, size);
+      if (m_socket->Send(packet) < 0)
+      {
+        Fail();
+        return;
+      }
+      m_offset += size;
+      if (m_offset < message.length())
+      {
+        continue;
+      }
+      m_queue.pop_front();
+      m_offset = 0;
+      m_sent++;
+    }
+  }
+
+  void IoTNetConnection::Fail()
+  {
+    // keep the queue, it is sent again over the next connection
+    Close();
+    m_reconnectEvent = Simulator::Schedule(m_backoff, &IoTNetConnection::Connect, this);
+    m_backoff = std::min(m_backoff * 2, m_maxBackoff);
+  }
+
+  void IoTNetConnection::ConnectionSucceeded(Ptr<Socket> socket)
+  {
+    m_state = CONNECTED;
+    m_backoff = m_initialBackoff;
+    m_connects++;
+    Flush();
+  }
+
+  void IoTNetConnection::ConnectionFailed(Ptr<Socket> socket)
+  {
+    Fail();
+  }
+
+  void IoTNetConnection::NormalClose(Ptr<Socket> socket)
+  {
+    Fail();
+  }
+
+  void IoTNetConnection::ErrorClose(Ptr<Socket> socket)
+  {
+    Fail();
+  }
+
+  void IoTNetConnection::SendSpace(Ptr<Socket> socket, uint32_t available)
+  {
+    Flush();
+  }
+}
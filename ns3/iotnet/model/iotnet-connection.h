@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef IOTNET_CONNECTION_H
+#define IOTNET_CONNECTION_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+
+#include <deque>
+
+namespace ns3
+{
+  /**
+   * One long-lived connection from a node to the IoTNet server.
+   *
+   * Messages sent while the TCP connection is being set up, or while the
+   * socket buffer is full, wait in a bounded queue and are flushed once the
+   * socket is writable. A frame larger than the free send buffer is written
+   * in pieces, so frames up to the IoTNetFrameBuffer limit never stall. A
+   * failed or closed connection is retried with an exponential backoff.
+   * Messages go out as IoTNetFrameBuffer frames so the server can split the
+   * stream again. In UDP mode every message is one datagram and no
+   * connection state is kept.
+   *
+   * A message the server could never accept, larger than the frame limit
+   * or, in UDP mode, than one datagram, is dropped by Send() instead of
+   * blocking the queue behind it.
+   */
+  class IoTNetConnection : public Object
+  {
+  public:
+    enum State
+    {
+      IDLE = 0,
+      CONNECTING,
+      CONNECTED
+    };
+
+    /**
+     * \param maxQueue messages waiting for the connection, the oldest is
+     *        dropped beyond it
+     * \param initialBackoff delay before the first reconnect, doubled on
+     *        every failure
+     * \param maxBackoff longest delay between reconnects
+     */
+    IoTNetConnection(Ptr<Node> node, Address peer, bool udp, uint32_t maxQueue = 64,
+                     Time initialBackoff = MilliSeconds(500), Time maxBackoff = Seconds(30));
+    ~IoTNetConnection();
+
+    // largest UDP payload over IPv4
+    static const uint32_t maxDatagramSize = 65507;
+
+    void Send(std::string message);
+    void Close();
+
+    State GetState() const;
+    uint32_t GetQueued() const;
+    uint64_t GetSent() const;
+    uint64_t GetDropped() const;
+    uint32_t GetConnects() const;
+
+  private:
+    void Connect();
+    void Flush();
+    void Fail();
+
+    void ConnectionSucceeded(Ptr<Socket> socket);
+    void ConnectionFailed(Ptr<Socket> socket);
+    void NormalClose(Ptr<Socket> socket);
+    void ErrorClose(Ptr<Socket> socket);
+    void SendSpace(Ptr<Socket> socket, uint32_t available);
+
+    Ptr<Node> m_node;
+    Address m_peer;
+    bool m_udp;
+    uint32_t m_maxQueue;
+    Time m_initialBackoff;
+    Time m_maxBackoff;
+    Ptr<Socket> m_socket;
+    State m_state;
+    std::deque<std::string> m_queue;
+    uint32_t m_offset; // bytes of the front frame already written
+    Time m_backoff;
+    EventId m_reconnectEvent;
+
+    uint64_t m_sent;
+    uint64_t m_dropped;
+    uint32_t m_connects;
+  };
+}
+
+#endif /* IOTNET_CONNECTION_H */
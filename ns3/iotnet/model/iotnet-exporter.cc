@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "iotnet-exporter.h"
+#include "cpr/cpr.h"
+
+#include <chrono>
+
+namespace ns3
+{
+  IoTNetExporter::IoTNetExporter(PostFunction post, uint32_t capacity, uint32_t flushSize, uint32_t flushIntervalMs)
+      : m_post(post),
+        m_slots(capacity),
+        m_flushSize(flushSize),
+        m_flushIntervalMs(flushIntervalMs),
+        m_head(0),
+        m_tail(0),
+        m_running(false),
+        m_pushed(0),
+        m_dropped(0),
+        m_backpressure(0),
+        m_sent(0),
+        m_batches(0),
+        m_failed(0)
+  {
+    NS_ASSERT(capacity > 0);
+    NS_ASSERT(flushSize > 0);
+  }
+
+  IoTNetExporter::~IoTNetExporter()
+  {
+    Stop();
+  }
+
+  IoTNetExporter::PostFunction IoTNetExporter::HttpPost(const std::string url)
+  {
+    return [url](const std::string &body) {
+      cpr::Response r = cpr::Post(
+          cpr::Url{url},
+          cpr::Header{{"accept", "application/json"}, {"content-type", "application/json"}},
+          cpr::Body{body});
+      return r.status_code >= 200 && r.status_code < 300;
+    };
+  }
+
+  void IoTNetExporter::Start()
+  {
+    if (m_running.exchange(true))
+    {
+      return;
+    }
+    m_thread = std::thread(&IoTNetExporter::Run, this);
+  }
+
+  void IoTNetExporter::Stop()
+  {
+    if (m_running.exchange(false))
+    {
+      m_wake.notify_one();
+      m_thread.join();
+    }
+  }
+
+  bool IoTNetExporter::Push(std::string reading)
+  {
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    uint64_t queued = tail - m_head.load(std::memory_order_acquire);
+
+    if (queued >= m_slots.size())
+    {
+      m_dropped++;
+      return false;
+    }
+    if (queued * 4 >= m_slots.size() * 3)
+    {
+      m_backpressure++;
+    }
+
+    m_slots[tail % m_slots.size()] = std::move(reading);
+    m_tail.store(tail + 1, std::memory_order_release);
+    m_pushed++;
+
+    // wake the sender early once a full batch is waiting, a lost wakeup
+    // only delays the batch until the next flush interval
+    if (queued + 1 == m_flushSize)
+    {
+      m_wake.notify_one();
+    }
+    return true;
+  }
+
+  uint32_t IoTNetExporter::GetQueued() const
+  {
+    return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+  }
+
+  uint64_t IoTNetExporter::GetPushed() const
+  {
+    return m_pushed;
+  }
+
+  uint64_t IoTNetExporter::GetDropped() const
+  {
+    return m_dropped;
+  }
+
+  uint64_t IoTNetExporter::GetBackpressure() const
+  {
+    return m_backpressure;
+  }
+
+  uint64_t IoTNetExporter::GetSent() const
+  {
+    return m_sent;
+  }
+
+  uint64_t IoTNetExporter::GetBatches() const
+  {
+    return m_batches;
+  }
+
+  uint64_t IoTNetExporter::GetFailed() const
+  {
+    return m_failed;
+  }
+
+  void IoTNetExporter::Run()
+  {
+    while (m_running)
+    {
+      if (GetQueued() < m_flushSize)
+      {
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait_for(lock, std::chrono::milliseconds(m_flushIntervalMs));
+      }
+      while (Drain(m_flushSize) == m_flushSize)
+      {
+      }
+    }
+
+    // flush whatever is left after Stop()
+    while (Drain(m_flushSize) > 0)
+    {
+    }
+  }
+
+  uint32_t IoTNetExporter::Drain(uint32_t max)
+  {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    uint64_t tail = m_tail.load(std::memory_order_acquire);
+    uint32_t count = std::min<uint64_t>(tail - head, max);
+
+    if (count == 0)
+    {
+      return 0;
+    }
+
+    std::string body = "[";
+    for (uint32_t i = 0; i < count; i++)
+    {
+      std::string &slot = m_slots[(head + i) % m_slots.size()];
+      if (i > 0)
+      {
+        body += ",";
+      }
+      body += slot;
+      slot.clear();
+    }
+    body += "]";
+
+    // release the slots before the slow post so the producer can refill them
+    m_head.store(head + count, std::memory_order_release);
+
+    if (m_post(body))
+    {
+      m_sent += count;
+      m_batches++;
+    }
+    else
+    {
+      m_failed += count;
+    }
+    return count;
+  }
+}
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef IOTNET_EXPORTER_H
+#define IOTNET_EXPORTER_H
+
+#include "ns3/core-module.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace ns3
+{
+  /**
+   * Ships readings received by the IoTNetServer to the external web server
+   * without blocking the simulator.
+   *
+   * Push() is called from the simulation thread and only writes into a
+   * bounded single-producer/single-consumer ring. A background thread drains
+   * the ring and posts the readings as one JSON array per batch, either when
+   * FlushSize readings are waiting or every FlushInterval milliseconds.
+   * When the ring is full new readings are dropped and counted, the event
+   * loop is never stalled by the HTTP round-trip.
+   */
+  class IoTNetExporter : public Object
+  {
+  public:
+    /**
+     * Sends one batch (a JSON array) and returns true on success.
+     */
+    typedef std::function<bool(const std::string &body)> PostFunction;
+
+    IoTNetExporter(PostFunction post, uint32_t capacity, uint32_t flushSize, uint32_t flushIntervalMs);
+    ~IoTNetExporter();
+
+    /**
+     * \returns a PostFunction doing a blocking cpr::Post of the body to url.
+     */
+    static PostFunction HttpPost(const std::string url);
+
+    void Start();
+    void Stop();
+
+    /**
+     * Queue one JSON document. Never blocks, must only be called from a
+     * single thread (the simulator thread).
+     *
+     * \returns false if the queue was full and the reading was dropped.
+     */
+    bool Push(std::string reading);
+
+    uint32_t GetQueued() const;
+    uint64_t GetPushed() const;
+    uint64_t GetDropped() const;
+    uint64_t GetBackpressure() const;
+    uint64_t GetSent() const;
+    uint64_t GetBatches() const;
+    uint64_t GetFailed() const;
+
+  private:
+    void Run();
+    uint32_t Drain(uint32_t max);
+
+    PostFunction m_post;
+    std::vector<std::string> m_slots;
+    uint32_t m_flushSize;
+    uint32_t m_flushIntervalMs;
+
+    // ring indices, m_tail is written by the producer, m_head by the sender
+    std::atomic<uint64_t> m_head;
+    std::atomic<uint64_t> m_tail;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+
+    // counters
+    std::atomic<uint64_t> m_pushed;       // readings accepted into the queue
+    std::atomic<uint64_t> m_dropped;      // readings lost because the queue was full
+    std::atomic<uint64_t> m_backpressure; // pushes that found the queue above 3/4 full
+    std::atomic<uint64_t> m_sent;         // readings delivered by successful posts
+    std::atomic<uint64_t> m_batches;      // successful posts
+    std::atomic<uint64_t> m_failed;       // readings lost in failed posts
+  };
+}
+
+#endif /* IOTNET_EXPORTER_H */
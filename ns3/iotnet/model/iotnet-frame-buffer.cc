@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "iotnet-frame-buffer.h"
+
+#include <cstring>
+
+namespace ns3
+{
+  IoTNetFrameBuffer::IoTNetFrameBuffer(uint32_t maxFrameSize)
+      : m_begin(0),
+        m_end(0),
+        m_maxFrameSize(maxFrameSize),
+        m_corrupt(false)
+  {
+  }
+
+  std::string IoTNetFrameBuffer::Frame(const std::string &payload)
+  {
+    uint32_t size = payload.size();
+    std::string frame;
+    frame.reserve(headerSize + size);
+    frame.push_back(char((size >> 24) & 0xff));
+    frame.push_back(char((size >> 16) & 0xff));
+    frame.push_back(char((size >> 8) & 0xff));
+    frame.push_back(char(size & 0xff));
+    frame.append(payload);
+    return frame;
+  }
+
+  void IoTNetFrameBuffer::Append(Ptr<const Packet> packet)
+  {
+    uint32_t size = packet->GetSize();
+    if (m_corrupt || size == 0)
+    {
+      return;
+    }
+
+    // move the partial frame to the front instead of growing
+    if (m_begin == m_end)
+    {
+      m_begin = m_end = 0;
+    }
+    else if (m_begin > 0 && m_buffer.size() - m_end < size)
+    {
+      std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+      m_end -= m_begin;
+      m_begin = 0;
+    }
+    if (m_buffer.size() - m_end < size)
+    {
+      m_buffer.resize(m_end + size);
+    }
+
+    packet->CopyData(m_buffer.data() + m_end, size);
+    m_end += size;
+  }
+
+  bool IoTNetFrameBuffer::Next(const uint8_t *&data, uint32_t &size)
+  {
+    if (m_corrupt || m_end - m_begin < headerSize)
+    {
+      return false;
+    }
+
+    const uint8_t *header = m_buffer.data() + m_begin;
+    uint32_t length = (uint32_t(header[0]) << 24) | (uint32_t(header[1]) << 16) | (uint32_t(header[2]) << 8) | header[3];
+    if (length > m_maxFrameSize)
+    {
+      m_corrupt = true;
+      return false;
+    }
+    if (m_end - m_begin < headerSize + length)
+    {
+      return false;
+    }
+
+    data = header + headerSize;
+    size = length;
+    m_begin += headerSize + length;
+    return true;
+  }
+
+  void IoTNetFrameBuffer::Clear()
+  {
+    m_begin = m_end = 0;
+    m_corrupt = false;
+  }
+
+  bool IoTNetFrameBuffer::IsCorrupt() const
+  {
+    return m_corrupt;
+  }
+
+  uint32_t IoTNetFrameBuffer::GetBuffered() const
+  {
+    return m_end - m_begin;
+  }
+}
@@ -0,0 +1,57 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef IOTNET_FRAME_BUFFER_H
+#define IOTNET_FRAME_BUFFER_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+namespace ns3
+{
+  /**
+   * Reassembles length-prefixed frames from a byte stream. Every frame is a
+   * 4 byte big endian payload length followed by the payload, see Frame().
+   *
+   * TCP may split a frame over several receives or pack several frames into
+   * one, so the server keeps one buffer per connection. Each received chunk
+   * is copied once into the buffer, complete frames are then handed out as
+   * views into it. A frame announcing more than maxFrameSize bytes marks the
+   * stream as corrupt, so the buffer never holds more than one maximum frame
+   * plus one received chunk.
+   */
+  class IoTNetFrameBuffer
+  {
+  public:
+    static const uint32_t headerSize = 4;
+    static const uint32_t defaultMaxFrameSize = 256 * 1024;
+
+    IoTNetFrameBuffer(uint32_t maxFrameSize = defaultMaxFrameSize);
+
+    /**
+     * \returns payload with its length prefix.
+     */
+    static std::string Frame(const std::string &payload);
+
+    void Append(Ptr<const Packet> packet);
+
+    /**
+     * Take the next complete frame. data points into the buffer and stays
+     * valid until the next Append() or Clear().
+     *
+     * \returns false if no complete frame is buffered or the stream is corrupt.
+     */
+    bool Next(const uint8_t *&data, uint32_t &size);
+
+    void Clear();
+    bool IsCorrupt() const;
+    uint32_t GetBuffered() const;
+
+  private:
+    std::vector<uint8_t> m_buffer;
+    size_t m_begin; // first byte not yet handed out
+    size_t m_end;   // one past the last received byte
+    uint32_t m_maxFrameSize;
+    bool m_corrupt;
+  };
+}
+
+#endif /* IOTNET_FRAME_BUFFER_H */
@@ -14,29 +14,37 @@ namespace ns3
   void IoTNetNode::RemainingEnergy(double oldValue, double remainingEnergy)
   {
     NS_LOG_UNCOND(LogPrefix() << "Current remaining energy = " << remainingEnergy << "J");
+
+    std::stringstream record;
+    record << "{\"node\":\"" << id << "\",\"remaining\":" << remainingEnergy << "}";
+    IoTNet::world->Emit("energy", record.str());
   }
 
   void IoTNetNode::TotalEnergy(double oldValue, double totalEnergy)
   {
     NS_LOG_UNCOND(LogPrefix() << "Total energy consumed by radio = " << totalEnergy << "J");
+
+    std::stringstream record;
+    record << "{\"node\":\"" << id << "\",\"consumed\":" << totalEnergy << "}";
+    IoTNet::world->Emit("energy", record.str());
   }
 
   void IoTNetNode::ScheduleSendData()
   {
-    NS_LOG_UNCOND(LogPrefix() << "Schedule send data every 10 seconds to " << IoTNet::world->address);
+    NS_LOG_UNCOND(LogPrefix() << "Schedule send data every " << sendInterval.GetSeconds() << " seconds to " << IoTNet::world->address);
 
     SendPacket("hello world");
 
-    Simulator::Schedule(Seconds(1), &IoTNetNode::ScheduleSendData, this);
+    Simulator::Schedule(sendInterval, &IoTNetNode::ScheduleSendData, this);
   }
 
   void IoTNetNode::SendPacket(std::string message)
   {
-    Ptr<Socket> socket = Socket::CreateSocket(node.Get(0), TcpSocketFactory::GetTypeId());
-    socket->Bind();
-    socket->Connect(IoTNet::world->address);
-
-    Ptr<Packet> packet = Create<Packet>((uint8_t *)message.c_str(), message.length());
-    socket->Send(packet);
+    // one connection per node, reused for every reading
+    if (!connection)
+    {
+      connection = CreateObject<IoTNetConnection>(node.Get(0), IoTNet::world->address, IoTNet::world->udp);
+    }
+    connection->Send(message);
   }
 }
\ No newline at end of file
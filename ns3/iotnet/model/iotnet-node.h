@@ -7,6 +7,8 @@
 #include "ns3/wifi-module.h"
 #include "ns3/ipv4-interface-container.h"
 
+#include "ns3/iotnet-connection.h"
+
 namespace ns3
 {
   class IoTNetNode : public Object
@@ -17,6 +19,8 @@ namespace ns3
     NodeContainer node;
     NetDeviceContainer device;
     Ipv4InterfaceContainer interface;
+    Ptr<IoTNetConnection> connection;
+    Time sendInterval = Seconds(1);
 
     std::string LogPrefix();
     void RemainingEnergy(double oldValue, double remainingEnergy);
@@ -25,15 +25,19 @@ namespace ns3
 
   void IoTNetRouter::Add(NodeContainer nodes)
   {
+    // every link gets the next subnet of the router network, carrying over
+    // octets as needed, so repeated calls never reuse a subnet
     for (size_t i = 0; i < nodes.GetN(); i++)
     {
       NodeContainer group(m_node, nodes.Get(i));
       NetDeviceContainer devices = p2p.Install(group);
 
-      std::ostringstream subnet;
-      subnet << "10.2." << i + 1 << ".0";
-      m_ipv4.SetBase(subnet.str().c_str(), "255.255.255.0");
       Ipv4InterfaceContainer interfaces = m_ipv4.Assign(devices);
+      m_ipv4.NewNetwork();
+
+      // the AP sends everything up, the router routes its cell down
+      IoTNet::world->SetDefaultRoute(nodes.Get(i), devices.Get(1), interfaces.GetAddress(0));
+      IoTNet::world->AddRoutesBehind(m_node.Get(0), devices.Get(0), interfaces.GetAddress(1), nodes.Get(i), devices.Get(1));
     }
   }
 
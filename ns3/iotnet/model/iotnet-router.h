@@ -8,6 +8,11 @@
 
 namespace ns3
 {
+  /**
+   * Connects access points to the server. Each access point gets its own
+   * point to point link, addressed from consecutive subnets of network/mask,
+   * so a /30 mask inside 10.2.0.0/16 leaves room for 16384 links.
+   */
   class IoTNetRouter : public Object
   {
   public:
@@ -0,0 +1,383 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "nlohmann/json.hpp"
+
+#include "iotnet-scenario.h"
+
+#include <algorithm>
+#include <fstream>
+
+using json = nlohmann::json;
+
+namespace ns3
+{
+  std::map<std::string, IoTNetScenario::Description> IoTNetScenario::cache;
+
+  static Vector ParsePosition(const json &value)
+  {
+    std::vector<double> xyz = value.get<std::vector<double>>();
+    if (xyz.size() < 2 || xyz.size() > 3)
+    {
+      NS_FATAL_ERROR("IoTNetScenario: position must be [x, y] or [x, y, z], got " << value.dump());
+    }
+    return Vector(xyz[0], xyz[1], xyz.size() == 3 ? xyz[2] : 0.0);
+  }
+
+  static IoTNetScenario::Endpoint ParseEndpoint(const json &value)
+  {
+    IoTNetScenario::Endpoint endpoint;
+    endpoint.id = value.at("id").get<std::string>();
+    endpoint.network = Ipv4Address(value.at("network").get<std::string>().c_str());
+    endpoint.mask = Ipv4Mask(value.value("mask", std::string("255.255.255.0")).c_str());
+    endpoint.position = ParsePosition(value.at("position"));
+    return endpoint;
+  }
+
+  static IoTNetScenario::Agent ParseAgent(const json &value)
+  {
+    IoTNetScenario::Agent agent;
+    if (value.contains("node"))
+    {
+      agent.nodes.push_back(value.at("node").get<std::string>());
+    }
+    if (value.contains("nodes"))
+    {
+      for (const json &node : value.at("nodes"))
+      {
+        agent.nodes.push_back(node.get<std::string>());
+      }
+    }
+    agent.type = value.at("type").get<std::string>();
+    agent.start = value.value("start", 0.0);
+    if (value.contains("attributes"))
+    {
+      for (auto &attribute : value.at("attributes").items())
+      {
+        // numbers and booleans are handed to the attribute checker as text
+        agent.attributes[attribute.key()] = attribute.value().is_string() ? attribute.value().get<std::string>() : attribute.value().dump();
+      }
+    }
+    return agent;
+  }
+
+  IoTNetScenario::IoTNetScenario(const std::string path)
+  {
+    auto cached = cache.find(path);
+    if (cached != cache.end())
+    {
+      m_description = cached->second;
+      return;
+    }
+
+    std::ifstream file(path);
+    NS_ABORT_MSG_UNLESS(file.is_open(), "IoTNetScenario: cannot open " << path);
+    std::stringstream text;
+    text << file.rdbuf();
+
+    m_description = Parse(text.str());
+    cache[path] = m_description;
+  }
+
+  IoTNetScenario::IoTNetScenario(const Description &description)
+      : m_description(description)
+  {
+  }
+
+  IoTNetScenario::Description IoTNetScenario::Parse(const std::string &text)
+  {
+    Description description;
+
+    try
+    {
+      json scenario = json::parse(text);
+
+      description.name = scenario.value("name", std::string("scenario"));
+      description.server = ParseEndpoint(scenario.at("server"));
+      description.router = ParseEndpoint(scenario.at("router"));
+
+      for (const json &cell : scenario.at("wifi"))
+      {
+        Cell wifi;
+        static_cast<Endpoint &>(wifi) = ParseEndpoint(cell);
+        if (cell.contains("sensors"))
+        {
+          for (const json &sensor : cell.at("sensors"))
+          {
+            wifi.sensors.push_back({sensor.at("id").get<std::string>(), ParsePosition(sensor.at("position"))});
+          }
+        }
+        description.wifi.push_back(wifi);
+      }
+
+      if (scenario.at("router").contains("links"))
+      {
+        description.links = scenario.at("router").at("links").get<std::vector<std::string>>();
+      }
+      else
+      {
+        for (const Cell &cell : description.wifi)
+        {
+          description.links.push_back(cell.id);
+        }
+      }
+
+      if (scenario.contains("jammers"))
+      {
+        for (const json &jammer : scenario.at("jammers"))
+        {
+          description.jammers.push_back(ParseAgent(jammer));
+        }
+      }
+      if (scenario.contains("mitigators"))
+      {
+        for (const json &mitigator : scenario.at("mitigators"))
+        {
+          description.mitigators.push_back(ParseAgent(mitigator));
+        }
+      }
+      if (scenario.contains("traffic"))
+      {
+        for (const json &traffic : scenario.at("traffic"))
+        {
+          description.traffic.push_back({traffic.at("node").get<std::string>(),
+                                         traffic.value("start", 1.0),
+                                         traffic.value("interval", 1.0)});
+        }
+      }
+
+      json metrics = scenario.value("metrics", json::object());
+      description.sender = metrics.value("sender", std::string());
+      description.receiver = metrics.value("receiver", std::string());
+
+      json utilities = scenario.value("utilities", json::object());
+      description.utilities.all = utilities.value("all", false);
+      description.utilities.cells = utilities.value("cells", std::vector<std::string>());
+      description.utilities.nodes = utilities.value("nodes", std::vector<std::string>());
+    }
+    catch (const json::exception &e)
+    {
+      NS_FATAL_ERROR("IoTNetScenario: " << e.what());
+    }
+
+    return description;
+  }
+
+  void IoTNetScenario::Build()
+  {
+    NS_ASSERT_MSG(IoTNet::world, "IoTNetScenario: IoTNet::world must be created first");
+
+    // server
+    const Endpoint &server = m_description.server;
+    m_server = CreateObject<IoTNetServer>(server.id, server.network, server.mask, server.position);
+
+    // wifi network
+    for (const Cell &cell : m_description.wifi)
+    {
+      m_wifi.emplace_back(new IoTNetWifi(cell.id, cell.network, cell.mask, cell.position));
+      m_nodes[cell.id] = m_wifi.back()->GetAp();
+      for (const Sensor &sensor : cell.sensors)
+      {
+        m_nodes[sensor.id] = m_wifi.back()->Create(sensor.id, sensor.position);
+      }
+    }
+
+    // router
+    const Endpoint &router = m_description.router;
+    m_router = CreateObject<IoTNetRouter>(router.id, router.network, router.mask, router.position);
+    m_server->Add(m_router->GetNode());
+
+    NodeContainer apNodes;
+    for (const std::string &link : m_description.links)
+    {
+      apNodes.Add(GetNode(link)->node);
+    }
+    m_router->Add(apNodes);
+
+    IoTNet::world->address = m_server->GetAddress();
+
+    // wireless utility, must be in place before jammers and mitigators
+    WirelessModuleUtilityHelper utilityHelper;
+    utilityHelper.SetInclusionList(std::vector<std::string>());
+    utilityHelper.SetExclusionList(std::vector<std::string>());
+    if (!m_description.utilities.all)
+    {
+      SelectUtilityNodes();
+      utilityHelper.SetFilter(MakeCallback(&IoTNetScenario::NeedsUtility, this));
+    }
+    utilityHelper.InstallAll();
+
+    // jammer
+    for (const Agent &agent : m_description.jammers)
+    {
+      JammerHelper jammerHelper;
+      jammerHelper.SetJammerType(agent.type);
+      for (auto &attribute : agent.attributes)
+      {
+        jammerHelper.Set(attribute.first, StringValue(attribute.second));
+      }
+      for (const std::string &id : agent.nodes)
+      {
+        m_jammers.Add(jammerHelper.Install(GetNode(id)->node.Get(0)));
+        m_jammerStart.push_back(agent.start);
+      }
+    }
+
+    // jamming mitigation
+    for (const Agent &agent : m_description.mitigators)
+    {
+      JammingMitigationHelper mitigationHelper;
+      mitigationHelper.SetJammingMitigationType(agent.type);
+      for (auto &attribute : agent.attributes)
+      {
+        mitigationHelper.Set(attribute.first, StringValue(attribute.second));
+      }
+      for (const std::string &id : agent.nodes)
+      {
+        m_mitigators.Add(mitigationHelper.Install(GetNode(id)->node.Get(0)));
+        m_mitigatorStart.push_back(agent.start);
+      }
+    }
+
+    // traffic
+    for (const Traffic &traffic : m_description.traffic)
+    {
+      Ptr<IoTNetNode> node = GetNode(traffic.node);
+      node->sendInterval = Seconds(traffic.interval);
+      Simulator::Schedule(Seconds(traffic.start), &IoTNetNode::ScheduleSendData, node);
+    }
+  }
+
+  void IoTNetScenario::Start(bool jamming)
+  {
+    if (jamming)
+    {
+      for (uint32_t i = 0; i < m_jammers.GetN(); i++)
+      {
+        Simulator::Schedule(Seconds(m_jammerStart[i]), &Jammer::StartJammer, m_jammers.Get(i));
+      }
+    }
+    for (uint32_t i = 0; i < m_mitigators.GetN(); i++)
+    {
+      Simulator::Schedule(Seconds(m_mitigatorStart[i]), &JammingMitigation::StartMitigation, m_mitigators.Get(i));
+    }
+  }
+
+  const IoTNetScenario::Description &IoTNetScenario::GetDescription() const
+  {
+    return m_description;
+  }
+
+  Ptr<IoTNetNode> IoTNetScenario::GetNode(const std::string id)
+  {
+    auto node = m_nodes.find(id);
+    if (node == m_nodes.end())
+    {
+      NS_FATAL_ERROR("IoTNetScenario: unknown wifi node " << id);
+    }
+    return node->second;
+  }
+
+  Ptr<WirelessModuleUtility> IoTNetScenario::GetUtility(const std::string id)
+  {
+    Ptr<Node> node = IoTNet::world->Find(id);
+    NS_ABORT_MSG_UNLESS(node, "IoTNetScenario: unknown node " << id);
+    return node->GetObject<WirelessModuleUtility>();
+  }
+
+  Ptr<WirelessModuleUtility> IoTNetScenario::GetSender()
+  {
+    // without metrics, node 0 and node 1 as main.cc always did
+    if (m_description.sender.empty())
+    {
+      return NodeList::GetNode(0)->GetObject<WirelessModuleUtility>();
+    }
+    return GetUtility(m_description.sender);
+  }
+
+  Ptr<WirelessModuleUtility> IoTNetScenario::GetReceiver()
+  {
+    if (m_description.receiver.empty())
+    {
+      return NodeList::GetNode(1)->GetObject<WirelessModuleUtility>();
+    }
+    return GetUtility(m_description.receiver);
+  }
+
+  JammerContainer IoTNetScenario::GetJammers()
+  {
+    return m_jammers;
+  }
+
+  JammingMitigationContainer IoTNetScenario::GetMitigators()
+  {
+    return m_mitigators;
+  }
+
+  void IoTNetScenario::PrintFootprint(std::ostream &os)
+  {
+    WirelessModuleUtilityHelper::PrintFootprint(os, NodeContainer::GetGlobal(), MakeCallback(&IoTNet::GetName, IoTNet::world));
+  }
+
+  void IoTNetScenario::SelectUtilityNodes()
+  {
+    const Utilities &utilities = m_description.utilities;
+    bool everyWifiNode = utilities.cells.empty() && utilities.nodes.empty();
+
+    for (const Cell &cell : m_description.wifi)
+    {
+      bool listed = std::find(utilities.cells.begin(), utilities.cells.end(), cell.id) != utilities.cells.end();
+      std::vector<std::string> ids(1, cell.id);
+      for (const Sensor &sensor : cell.sensors)
+      {
+        ids.push_back(sensor.id);
+      }
+      for (const std::string &id : ids)
+      {
+        bool matched = false;
+        for (const std::string &pattern : utilities.nodes)
+        {
+          matched = matched || WirelessModuleUtilityHelper::MatchName(pattern, id);
+        }
+        if (everyWifiNode || listed || matched)
+        {
+          m_utilityNodes.insert(GetNode(id)->node.Get(0)->GetId());
+        }
+      }
+    }
+
+    // nodes the agents and the metrics depend on
+    std::vector<std::string> required;
+    for (const Agent &agent : m_description.jammers)
+    {
+      required.insert(required.end(), agent.nodes.begin(), agent.nodes.end());
+    }
+    for (const Agent &agent : m_description.mitigators)
+    {
+      required.insert(required.end(), agent.nodes.begin(), agent.nodes.end());
+    }
+    required.push_back(m_description.sender);
+    required.push_back(m_description.receiver);
+    for (const std::string &id : required)
+    {
+      Ptr<Node> node = id.empty() ? nullptr : IoTNet::world->Find(id);
+      if (node)
+      {
+        m_utilityNodes.insert(node->GetId());
+      }
+    }
+    // without metrics GetSender and GetReceiver use node 0 and 1
+    if (m_description.sender.empty() && NodeList::GetNNodes() > 0)
+    {
+      m_utilityNodes.insert(0);
+    }
+    if (m_description.receiver.empty() && NodeList::GetNNodes() > 1)
+    {
+      m_utilityNodes.insert(1);
+    }
+  }
+
+  bool IoTNetScenario::NeedsUtility(Ptr<Node> node)
+  {
+    return m_utilityNodes.count(node->GetId()) > 0;
+  }
+}
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef IOTNET_SCENARIO_H
+#define IOTNET_SCENARIO_H
+
+#include "ns3/core-module.h"
+#include "ns3/jamming-module.h"
+
+#include "ns3/iotnet.h"
+#include "ns3/iotnet-node.h"
+#include "ns3/iotnet-wifi.h"
+#include "ns3/iotnet-server.h"
+#include "ns3/iotnet-router.h"
+
+#include <map>
+#include <memory>
+#include <set>
+
+namespace ns3
+{
+  /**
+   * Topology and traffic of one simulation, read from a JSON file instead of
+   * being hardcoded in main.cc:
+   *
+   * {
+   *   "name": "home",
+   *   "server": {"id": "server", "network": "10.1.1.0", "mask": "255.255.255.0", "position": [50, 5, 0]},
+   *   "router": {"id": "router", "network": "10.2.0.0", "mask": "255.255.255.252", "position": [50, 15, 0],
+   *              "links": ["wifi-a", ...]},
+   *   "wifi": [{"id": "wifi-a", "network": "10.1.3.0", "mask": "255.255.255.0", "position": [50, 40, 0],
+   *             "sensors": [{"id": "s1", "position": [55, 25, 0]}, ...]}, ...],
+   *   "jammers": [{"node": "j", "type": "ns3::ReactiveJammer", "start": 2, "attributes": {"Name": "value"}}],
+   *   "mitigators": [{"nodes": ["s1"], "type": "ns3::MitigateByChannelHop", "start": 0, "attributes": {}}],
+   *   "traffic": [{"node": "s1", "start": 1, "interval": 1}],
+   *   "metrics": {"sender": "server", "receiver": "wifi-a"},
+   *   "utilities": {"cells": ["wifi-a"], "nodes": ["s*"], "all": false}
+   * }
+   *
+   * Positions are [x, y, z] in meters, times in seconds. Attribute values are
+   * strings (or numbers) parsed by the attribute checker, e.g. "2s".
+   * "router.links" defaults to every wifi cell in file order. Everything but
+   * "server", "router" and "wifi" is optional.
+   *
+   * Wireless utilities go on wifi nodes only: every wifi node by default,
+   * or, with "utilities.cells" and/or "utilities.nodes" (name patterns with
+   * '*' and '?'), the nodes of the listed cells and the matching nodes.
+   * Jammer, mitigator and metrics nodes always get one. "utilities.all"
+   * installs on every node like InstallAll.
+   *
+   * Parsed files are cached by path, building the same scenario again in one
+   * process does not touch the file system.
+   */
+  class IoTNetScenario : public Object
+  {
+  public:
+    struct Endpoint
+    {
+      std::string id;
+      Ipv4Address network;
+      Ipv4Mask mask;
+      Vector position;
+    };
+
+    struct Sensor
+    {
+      std::string id;
+      Vector position;
+    };
+
+    struct Cell : Endpoint
+    {
+      std::vector<Sensor> sensors;
+    };
+
+    struct Agent
+    {
+      std::vector<std::string> nodes;
+      std::string type;
+      std::map<std::string, std::string> attributes;
+      double start;
+    };
+
+    struct Traffic
+    {
+      std::string node;
+      double start;
+      double interval;
+    };
+
+    struct Utilities
+    {
+      bool all = false;
+      std::vector<std::string> cells;
+      std::vector<std::string> nodes;
+    };
+
+    struct Description
+    {
+      std::string name;
+      Endpoint server;
+      Endpoint router;
+      std::vector<std::string> links;
+      std::vector<Cell> wifi;
+      std::vector<Agent> jammers;
+      std::vector<Agent> mitigators;
+      std::vector<Traffic> traffic;
+      std::string sender;
+      std::string receiver;
+      Utilities utilities;
+    };
+
+    IoTNetScenario(const std::string path);
+    IoTNetScenario(const Description &description);
+
+    /**
+     * Parse a scenario document, aborts with the offending field on error.
+     */
+    static Description Parse(const std::string &text);
+
+    /**
+     * Create server, wifi cells, router, wireless utilities, jammers and
+     * mitigators, and schedule the traffic. IoTNet::world must exist.
+     */
+    void Build();
+
+    /**
+     * Schedule the jammers (if jamming) and the mitigators at their start time.
+     */
+    void Start(bool jamming);
+
+    const Description &GetDescription() const;
+    Ptr<IoTNetNode> GetNode(const std::string id);
+    Ptr<WirelessModuleUtility> GetUtility(const std::string id);
+    Ptr<WirelessModuleUtility> GetSender();
+    Ptr<WirelessModuleUtility> GetReceiver();
+    JammerContainer GetJammers();
+    JammingMitigationContainer GetMitigators();
+
+    /**
+     * Write the wireless utility footprint of every node as CSV.
+     */
+    void PrintFootprint(std::ostream &os);
+
+  private:
+    static std::map<std::string, Description> cache;
+
+    void SelectUtilityNodes();
+    bool NeedsUtility(Ptr<Node> node);
+
+    Description m_description;
+    Ptr<IoTNetServer> m_server;
+    Ptr<IoTNetRouter> m_router;
+    std::vector<std::unique_ptr<IoTNetWifi>> m_wifi;
+    std::map<std::string, Ptr<IoTNetNode>> m_nodes;
+    std::vector<double> m_jammerStart;
+    std::vector<double> m_mitigatorStart;
+    JammerContainer m_jammers;
+    JammingMitigationContainer m_mitigators;
+    std::set<uint32_t> m_utilityNodes;
+  };
+}
+
+#endif /* IOTNET_SCENARIO_H */
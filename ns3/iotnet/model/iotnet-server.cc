@@ -4,7 +4,6 @@
 #include "ns3/iotnet.h"
 
 #include "iotnet-server.h"
-#include "cpr/cpr.h"
 
 namespace ns3
 {
@@ -24,34 +23,77 @@ namespace ns3
     IoTNet::world->Add(id, m_node, position);
   }
 
+  void IoTNetServer::Forward(const uint8_t *data, uint32_t size)
+  {
+    // reports are JSON text for the sinks whatever the wire format
+    std::string payload;
+    if (!IoTNetCodec::ToJson(data, size, IoTNet::world->format, payload))
+    {
+      NS_LOG_UNCOND("IoTNetServer: dropped undecodable " << IoTNetCodec::GetName(IoTNet::world->format) << " report of " << size << " bytes");
+      return;
+    }
+    std::cout << payload << std::endl;
+
+    // forward to the telemetry sink
+    IoTNet::world->Emit("reading", payload);
+  }
+
   void
   IoTNetServer::DataReceivedCallback(Ptr<Socket> socket)
   {
+    IoTNetFrameBuffer &frames = m_connections[socket];
+
     Ptr<Packet> packet;
     while ((packet = socket->Recv()))
     {
       packet->PrintPacketTags(std::cout);
+      frames.Append(packet);
 
-      // Process the received data
-      uint8_t buffer[packet->GetSize()];
-      packet->CopyData(buffer, packet->GetSize());
+      const uint8_t *data;
+      uint32_t size;
+      while (frames.Next(data, size))
+      {
+        Forward(data, size);
+      }
+    }
 
-      // Assuming the payload is a string, you can convert it to a C++ string
-      std::string payload(reinterpret_cast<char *>(buffer), packet->GetSize());
-      std::cout << payload << std::endl;
+    if (frames.IsCorrupt())
+    {
+      NS_LOG_UNCOND("IoTNetServer: oversized frame, closing connection");
+      m_connections.erase(socket);
+      socket->Close();
+    }
+  }
 
-      // forward to external server
-      cpr::Response r = cpr::Post(
-          cpr::Url{"server-node:3000/api/reading"},
-          cpr::Header{{"accept", "application/json"}},
-          cpr::Header{{"content-type", "application/json"}},
-          cpr::Body{{payload}});
+  void IoTNetServer::DatagramReceivedCallback(Ptr<Socket> socket)
+  {
+    Ptr<Packet> packet;
+    while ((packet = socket->Recv()))
+    {
+      // every datagram carries whole frames, nothing is kept across them
+      m_datagram.Clear();
+      m_datagram.Append(packet);
+
+      const uint8_t *data;
+      uint32_t size;
+      while (m_datagram.Next(data, size))
+      {
+        Forward(data, size);
+      }
     }
   }
 
   void IoTNetServer::ConnectionAcceptedCallback(Ptr<Socket> socket, const Address &address)
   {
+    m_connections[socket] = IoTNetFrameBuffer();
     socket->SetRecvCallback(MakeCallback(&IoTNetServer::DataReceivedCallback, this));
+    socket->SetCloseCallbacks(MakeCallback(&IoTNetServer::ConnectionClosedCallback, this),
+                              MakeCallback(&IoTNetServer::ConnectionClosedCallback, this));
+  }
+
+  void IoTNetServer::ConnectionClosedCallback(Ptr<Socket> socket)
+  {
+    m_connections.erase(socket);
   }
 
   void IoTNetServer::Add(NodeContainer node)
@@ -62,11 +104,20 @@ namespace ns3
     uint16_t sinkPort = 8080;
     m_sinkAddress = Address(InetSocketAddress(interfaces.GetAddress(0), sinkPort));
 
+    // one uplink each way, default routes cover every cell
+    IoTNet::world->SetDefaultRoute(m_node.Get(0), devices.Get(0), interfaces.GetAddress(1));
+    IoTNet::world->SetDefaultRoute(node.Get(0), devices.Get(1), interfaces.GetAddress(0));
+
     // application
     Ptr<Socket> socket = Socket::CreateSocket(m_node.Get(0), TcpSocketFactory::GetTypeId());
     socket->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address &>(), MakeCallback(&IoTNetServer::ConnectionAcceptedCallback, this));
     socket->Bind(m_sinkAddress);
     socket->Listen();
+
+    // readings sent as datagrams
+    Ptr<Socket> udpSocket = Socket::CreateSocket(m_node.Get(0), UdpSocketFactory::GetTypeId());
+    udpSocket->SetRecvCallback(MakeCallback(&IoTNetServer::DatagramReceivedCallback, this));
+    udpSocket->Bind(m_sinkAddress);
   }
 
   Address IoTNetServer::GetAddress()
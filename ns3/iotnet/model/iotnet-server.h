@@ -6,6 +6,10 @@
 #include "ns3/node-container.h"
 #include "ns3/point-to-point-module.h"
 
+#include "ns3/iotnet-frame-buffer.h"
+
+#include <map>
+
 namespace ns3
 {
   class IoTNetServer : public Object
@@ -15,6 +19,8 @@ namespace ns3
     void Add(const NodeContainer nodes);
     void ConnectionAcceptedCallback(Ptr<Socket> socket, const Address &address);
     void DataReceivedCallback(Ptr<Socket> socket);
+    void DatagramReceivedCallback(Ptr<Socket> socket);
+    void ConnectionClosedCallback(Ptr<Socket> socket);
     Address GetAddress();
 
   private:
@@ -22,6 +28,12 @@ namespace ns3
     Ipv4AddressHelper m_ipv4;
     PointToPointHelper p2p;
     Address m_sinkAddress;
+
+    // one reassembly buffer per accepted connection
+    std::map<Ptr<Socket>, IoTNetFrameBuffer> m_connections;
+    IoTNetFrameBuffer m_datagram;
+
+    void Forward(const uint8_t *data, uint32_t size);
   };
 }
 
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "iotnet-telemetry-sink.h"
+
+#include <zmq.h>
+
+namespace ns3
+{
+  IoTNetTelemetrySink::~IoTNetTelemetrySink()
+  {
+  }
+
+  void IoTNetTelemetrySink::Start()
+  {
+  }
+
+  void IoTNetTelemetrySink::Stop()
+  {
+  }
+
+  void IoTNetTelemetrySink::PrintStats(std::ostream &os) const
+  {
+  }
+
+  // http
+
+  IoTNetHttpSink::IoTNetHttpSink(const std::string url, uint32_t capacity, uint32_t flushSize, uint32_t flushIntervalMs)
+  {
+    m_exporter = CreateObject<IoTNetExporter>(IoTNetExporter::HttpPost(url), capacity, flushSize, flushIntervalMs);
+  }
+
+  void IoTNetHttpSink::Write(const std::string &topic, const std::string &record)
+  {
+    if (topic == "reading")
+    {
+      m_exporter->Push(record);
+    }
+  }
+
+  void IoTNetHttpSink::Start()
+  {
+    m_exporter->Start();
+  }
+
+  void IoTNetHttpSink::Stop()
+  {
+    m_exporter->Stop();
+  }
+
+  void IoTNetHttpSink::PrintStats(std::ostream &os) const
+  {
+    os << "Exported = " << m_exporter->GetSent() << "/" << m_exporter->GetPushed()
+       << " in " << m_exporter->GetBatches() << " batches"
+       << ", dropped = " << m_exporter->GetDropped()
+       << ", failed = " << m_exporter->GetFailed()
+       << ", backpressure = " << m_exporter->GetBackpressure();
+  }
+
+  Ptr<IoTNetExporter> IoTNetHttpSink::GetExporter()
+  {
+    return m_exporter;
+  }
+
+  // file
+
+  IoTNetFileSink::IoTNetFileSink(const std::string path, bool binary)
+      : m_binary(binary),
+        m_records(0)
+  {
+    m_file.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    NS_ABORT_MSG_UNLESS(m_file.is_open(), "IoTNetFileSink: cannot open " << path);
+  }
+
+  void IoTNetFileSink::Write(const std::string &topic, const std::string &record)
+  {
+    if (m_binary)
+    {
+      uint8_t topicLength = std::min<size_t>(topic.size(), 255);
+      int64_t at = Simulator::Now().GetNanoSeconds();
+      uint32_t recordLength = record.size();
+      uint8_t header[12];
+      for (int i = 0; i < 8; i++)
+      {
+        header[i] = (at >> (8 * i)) & 0xff;
+      }
+      for (int i = 0; i < 4; i++)
+      {
+        header[8 + i] = (recordLength >> (8 * i)) & 0xff;
+      }
+      m_file.put(topicLength);
+      m_file.write(topic.data(), topicLength);
+      m_file.write(reinterpret_cast<char *>(header), sizeof(header));
+      m_file.write(record.data(), recordLength);
+    }
+    else
+    {
+      m_file << "{\"topic\":\"" << topic << "\",\"at\":" << Simulator::Now().GetSeconds()
+             << ",\"data\":" << record << "}\n";
+    }
+    m_records++;
+  }
+
+  void IoTNetFileSink::Stop()
+  {
+    m_file.flush();
+  }
+
+  void IoTNetFileSink::PrintStats(std::ostream &os) const
+  {
+    os << "Written = " << m_records << " records";
+  }
+
+  // zmq
+
+  IoTNetZmqSink::IoTNetZmqSink(const std::string endpoint, int highWaterMark)
+      : m_sent(0),
+        m_dropped(0)
+  {
+    m_context = zmq_ctx_new();
+    m_socket = zmq_socket(m_context, ZMQ_PUSH);
+    NS_ABORT_MSG_UNLESS(m_socket, "IoTNetZmqSink: cannot create socket");
+
+    int linger = 1000; // milliseconds to flush pending messages on close
+    zmq_setsockopt(m_socket, ZMQ_SNDHWM, &highWaterMark, sizeof(highWaterMark));
+    zmq_setsockopt(m_socket, ZMQ_LINGER, &linger, sizeof(linger));
+    NS_ABORT_MSG_UNLESS(zmq_connect(m_socket, endpoint.c_str()) == 0,
+                        "IoTNetZmqSink: cannot connect to " << endpoint << ": " << zmq_strerror(zmq_errno()));
+  }
+
+  IoTNetZmqSink::~IoTNetZmqSink()
+  {
+    Stop();
+  }
+
+  void IoTNetZmqSink::Write(const std::string &topic, const std::string &record)
+  {
+    if (!m_socket)
+    {
+      m_dropped++;
+      return;
+    }
+
+    // multipart messages are atomic, if the topic is queued so is the record
+    if (zmq_send(m_socket, topic.data(), topic.size(), ZMQ_SNDMORE | ZMQ_DONTWAIT) < 0)
+    {
+      m_dropped++;
+      return;
+    }
+    if (zmq_send(m_socket, record.data(), record.size(), ZMQ_DONTWAIT) < 0)
+    {
+      m_dropped++;
+      return;
+    }
+    m_sent++;
+  }
+
+  void IoTNetZmqSink::Stop()
+  {
+    if (m_socket)
+    {
+      zmq_close(m_socket);
+      m_socket = nullptr;
+    }
+    if (m_context)
+    {
+      zmq_ctx_term(m_context);
+      m_context = nullptr;
+    }
+  }
+
+  void IoTNetZmqSink::PrintStats(std::ostream &os) const
+  {
+    os << "Pushed = " << m_sent << " records, dropped = " << m_dropped;
+  }
+}
@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef IOTNET_TELEMETRY_SINK_H
+#define IOTNET_TELEMETRY_SINK_H
+
+#include "ns3/core-module.h"
+
+#include "ns3/iotnet-exporter.h"
+
+#include <fstream>
+
+namespace ns3
+{
+  /**
+   * Destination for everything the simulation reports: AP readings received
+   * by the server ("reading"), energy traces ("energy") and the end of run
+   * summary ("summary"). Records are JSON documents, the topic tells them
+   * apart.
+   */
+  class IoTNetTelemetrySink : public Object
+  {
+  public:
+    virtual ~IoTNetTelemetrySink();
+
+    virtual void Write(const std::string &topic, const std::string &record) = 0;
+    virtual void Start();
+    virtual void Stop();
+    virtual void PrintStats(std::ostream &os) const;
+  };
+
+  /**
+   * Forwards readings to the web server through a batching IoTNetExporter.
+   * The web API only understands readings, other topics are ignored.
+   */
+  class IoTNetHttpSink : public IoTNetTelemetrySink
+  {
+  public:
+    IoTNetHttpSink(const std::string url, uint32_t capacity, uint32_t flushSize, uint32_t flushIntervalMs);
+
+    virtual void Write(const std::string &topic, const std::string &record);
+    virtual void Start();
+    virtual void Stop();
+    virtual void PrintStats(std::ostream &os) const;
+    Ptr<IoTNetExporter> GetExporter();
+
+  private:
+    Ptr<IoTNetExporter> m_exporter;
+  };
+
+  /**
+   * Append-only file sink, no network I/O. In NDJSON mode every record is one
+   * line {"topic":..,"at":<simulation seconds>,"data":<record>}. In binary mode
+   * every record is a frame of
+   *   uint8 topic length | topic | int64 time (ns) | uint32 record length | record
+   * in little endian order, which is cheaper to write and to skip through.
+   */
+  class IoTNetFileSink : public IoTNetTelemetrySink
+  {
+  public:
+    IoTNetFileSink(const std::string path, bool binary);
+
+    virtual void Write(const std::string &topic, const std::string &record);
+    virtual void Stop();
+    virtual void PrintStats(std::ostream &os) const;
+
+  private:
+    std::ofstream m_file;
+    bool m_binary;
+    uint64_t m_records;
+  };
+
+  /**
+   * ZeroMQ PUSH sink. Each record is a two part message (topic, record).
+   * Sends never block: when the high water mark is reached the record is
+   * dropped and counted.
+   */
+  class IoTNetZmqSink : public IoTNetTelemetrySink
+  {
+  public:
+    IoTNetZmqSink(const std::string endpoint, int highWaterMark);
+    virtual ~IoTNetZmqSink();
+
+    virtual void Write(const std::string &topic, const std::string &record);
+    virtual void Stop();
+    virtual void PrintStats(std::ostream &os) const;
+
+  private:
+    void *m_context;
+    void *m_socket;
+    uint64_t m_sent;
+    uint64_t m_dropped;
+  };
+}
+
+#endif /* IOTNET_TELEMETRY_SINK_H */
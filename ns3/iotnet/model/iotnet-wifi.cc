@@ -4,12 +4,27 @@
 
 #include "iotnet-wifi.h"
 
+#include <cmath>
+
 using json = nlohmann::json;
 
 namespace ns3
 {
   int IoTNetWifi::currentWifiId = 0;
 
+  bool IoTNetWifi::deltaReports = false;
+  Time IoTNetWifi::reportInterval = Seconds(20);
+  Time IoTNetWifi::deltaInterval = Seconds(1);
+  double IoTNetWifi::rssThreshold = 1.0;
+  double IoTNetWifi::pdrThreshold = 0.05;
+  int64_t IoTNetWifi::epoch = 0;
+
+  static bool Changed(double value, double reported, double threshold)
+  {
+    // equal infinities (no signal yet) are unchanged, their difference is NaN
+    return !(value == reported || std::fabs(value - reported) < threshold);
+  }
+
   IoTNetWifi::IoTNetWifi(const std::string id, const Ipv4Address network, const Ipv4Mask mask, const Vector position)
   {
     // config
@@ -87,6 +102,12 @@ namespace ns3
     // ip
     iotNode->interface = m_ipv4.Assign(iotNode->device);
 
+    // sensors reach everything through their AP
+    if (currentIndex > 0)
+    {
+      IoTNet::world->SetDefaultRoute(iotNode->node.Get(0), iotNode->device.Get(0), GetAp()->interface.GetAddress(0));
+    }
+
     // append to vector
     m_allIoTNode.push_back(iotNode);
 
@@ -98,29 +119,60 @@ namespace ns3
 
   void IoTNetWifi::GatherInformation()
   {
+    bool keyframe = !deltaReports || m_seq == 0 || Simulator::Now() - m_lastKeyframe >= reportInterval;
+    if (m_reportedRss.size() < m_allNodes.GetN())
+    {
+      m_reportedRss.resize(m_allNodes.GetN(), NAN);
+      m_reportedPdr.resize(m_allNodes.GetN(), NAN);
+    }
+
     json payload;
 
     payload["ap"] = m_id;
-    payload["at"] = Now() * 1000;
-    payload["sensors"] = {};
+    payload["at"] = Now();
+    payload["sensors"] = json::array();
+    if (deltaReports)
+    {
+      payload["seq"] = m_seq;
+      payload["keyframe"] = keyframe;
+    }
 
     for (size_t i = 1; i < m_allNodes.GetN(); i++) // except ap
     {
       Ptr<IoTNetNode> iotNode = m_allIoTNode.at(i);
       Ptr<WirelessModuleUtility> utility = m_allNodes.Get(i)->GetObject<WirelessModuleUtility>();
 
-      if (iotNode->id == "jammer")
+      // jammers and cells left out of the utility install have nothing to report
+      if (iotNode->id == "jammer" || !utility)
+      {
+        continue;
+      }
+
+      double rss = WToDbm(utility->GetRss());
+      double pdr = pow(rss / 154, 2);
+      if (!keyframe && !Changed(rss, m_reportedRss[i], rssThreshold) && !Changed(pdr, m_reportedPdr[i], pdrThreshold))
       {
         continue;
       }
+      m_reportedRss[i] = rss;
+      m_reportedPdr[i] = pdr;
 
       payload["sensors"].push_back({{"name", iotNode->id},
-                                    {"rssi", {-200 - WToDbm(utility->GetRss())}},
-                                    {"pdr", {pow(WToDbm(utility->GetRss()) / 154, 2)}}});
+                                    {"rssi", {-200 - rss}},
+                                    {"pdr", {pdr}}});
     }
 
-    GetAp()->SendPacket(payload.dump());
-    Simulator::Schedule(Seconds(20), &IoTNetWifi::GatherInformation, this);
+    // in delta mode a sample without changes sends nothing
+    if (keyframe || !payload["sensors"].empty())
+    {
+      GetAp()->SendPacket(IoTNetCodec::Encode(payload, IoTNet::world->format));
+      m_seq++;
+    }
+    if (keyframe)
+    {
+      m_lastKeyframe = Simulator::Now();
+    }
+    Simulator::Schedule(deltaReports ? deltaInterval : reportInterval, &IoTNetWifi::GatherInformation, this);
   }
 
   void IoTNetWifi::Loop()
@@ -129,6 +181,10 @@ namespace ns3
     {
       Ptr<IoTNetNode> iotNode = m_allIoTNode.at(i);
       Ptr<WirelessModuleUtility> utility = m_allNodes.Get(i)->GetObject<WirelessModuleUtility>();
+      if (!utility)
+      {
+        continue;
+      }
 
       NS_LOG_UNCOND(m_id << " " << iotNode->id << " " << WToDbm(utility->GetRss()));
     }
@@ -147,8 +203,8 @@ namespace ns3
     return 10.0 * log10(w * 1000.0);
   }
 
-  std::time_t IoTNetWifi::Now()
+  int64_t IoTNetWifi::Now()
   {
-    return std::time(nullptr);
+    return epoch + Simulator::Now().GetMilliSeconds();
   }
 }
\ No newline at end of file
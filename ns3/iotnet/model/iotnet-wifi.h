@@ -12,22 +12,35 @@
 #include "ns3/iotnet.h"
 #include "ns3/iotnet-node.h"
 
-#include <ctime>
-
 namespace ns3
 {
+  /**
+   * One wifi cell: an AP and its sensors. The AP reports RSS and PDR of its
+   * sensors to the server, by default all of them every reportInterval. With
+   * deltaReports the AP samples every deltaInterval and only sends the
+   * sensors whose RSS moved by rssThreshold dB or whose PDR moved by
+   * pdrThreshold since they were last reported, plus a full keyframe every
+   * reportInterval. Delta reports carry "seq" and "keyframe" fields.
+   */
   class IoTNetWifi
   {
   public:
     static int currentWifiId;
 
+    static bool deltaReports;
+    static Time reportInterval;
+    static Time deltaInterval;
+    static double rssThreshold;
+    static double pdrThreshold;
+    static int64_t epoch; // milliseconds added to the simulation time in "at"
+
     IoTNetWifi(const std::string id, const Ipv4Address network, const Ipv4Mask mask, const Vector position);
     Ptr<IoTNetNode> Create(std::string id, Vector position);
     Ptr<IoTNetNode> GetAp();
     void Install();
     void GatherInformation();
     void Loop();
-    std::time_t Now();
+    int64_t Now();
 
     double DbmToW(double dBm) const;
     double WToDbm(double w) const;
@@ -48,6 +61,12 @@ namespace ns3
     Ipv4AddressHelper m_ipv4;
 
     std::vector<Ptr<IoTNetNode>> m_allIoTNode;
+
+    // last values sent per node index, for delta reports
+    std::vector<double> m_reportedRss;
+    std::vector<double> m_reportedPdr;
+    Time m_lastKeyframe;
+    uint32_t m_seq = 0;
   };
 }
 #endif /* IOTNET_WIFI_H */
\ No newline at end of file
@@ -1,11 +1,16 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 #include "iotnet.h"
 
+#include <algorithm>
+
 namespace ns3
 {
   Ptr<IoTNet> IoTNet::world = nullptr;
 
   IoTNet::IoTNet()
+      : udp(false),
+        globalRouting(false),
+        format(IoTNetCodec::JSON)
   {
     m_positionAlloc = CreateObject<ListPositionAllocator>();
   }
@@ -22,6 +27,8 @@ namespace ns3
     for (size_t i = 0; i < nodes.GetN(); i++)
     {
       Ptr<Node> n0 = nodes.Get(i);
+      m_nameIndex.emplace(name, m_allNodes.GetN());
+      m_nodeIndex[n0->GetId()] = m_allNodes.GetN();
       m_allNodes.Add(n0);
       m_positionAlloc->Add(position);
       m_allNames.push_back(name);
@@ -31,13 +38,128 @@ namespace ns3
 
   void IoTNet::Install()
   {
-    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    InstallRoutes();
+    InstallMobility();
+  }
 
+  void IoTNet::InstallRoutes()
+  {
+    if (globalRouting)
+    {
+      Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    }
+    for (const Route &route : m_routes)
+    {
+      InstallRoute(route);
+    }
+    m_routes.clear();
+  }
+
+  void IoTNet::InstallMobility()
+  {
     m_mobility.SetPositionAllocator(m_positionAlloc);
     m_mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     m_mobility.Install(m_allNodes);
   }
 
+  void IoTNet::Emit(const std::string topic, const std::string record)
+  {
+    if (sink)
+    {
+      sink->Write(topic, record);
+    }
+  }
+
+  Ptr<Node> IoTNet::Find(const std::string name)
+  {
+    auto it = m_nameIndex.find(name);
+    return it == m_nameIndex.end() ? nullptr : m_allNodes.Get(it->second);
+  }
+
+  std::string IoTNet::GetName(Ptr<Node> node)
+  {
+    auto it = m_nodeIndex.find(node->GetId());
+    return it == m_nodeIndex.end() ? "" : m_allNames[it->second];
+  }
+
+  void IoTNet::SetDefaultRoute(Ptr<Node> node, Ptr<NetDevice> device, Ipv4Address gateway)
+  {
+    if (!globalRouting)
+    {
+      m_routes.push_back({node, device, gateway, nullptr, nullptr});
+    }
+  }
+
+  void IoTNet::AddRoutesBehind(Ptr<Node> node, Ptr<NetDevice> device, Ipv4Address gateway, Ptr<Node> neighbour, Ptr<NetDevice> neighbourDevice)
+  {
+    if (!globalRouting)
+    {
+      m_routes.push_back({node, device, gateway, neighbour, neighbourDevice});
+    }
+  }
+
+  void IoTNet::InstallRoute(const Route &route)
+  {
+    Ptr<Ipv4> ipv4 = route.node->GetObject<Ipv4>();
+    Ipv4StaticRoutingHelper routingHelper;
+    Ptr<Ipv4StaticRouting> routing = routingHelper.GetStaticRouting(ipv4);
+    uint32_t interface = ipv4->GetInterfaceForDevice(route.device);
+
+    if (!route.neighbour)
+    {
+      routing->SetDefaultRoute(route.gateway, interface);
+      return;
+    }
+
+    // every subnet of the neighbour except loopback and the shared link, as
+    // (network, prefix length)
+    std::vector<std::pair<uint32_t, uint16_t>> prefixes;
+    Ptr<Ipv4> neighbourIpv4 = route.neighbour->GetObject<Ipv4>();
+    int32_t sharedInterface = neighbourIpv4->GetInterfaceForDevice(route.neighbourDevice);
+    for (uint32_t i = 1; i < neighbourIpv4->GetNInterfaces(); i++)
+    {
+      if (int32_t(i) == sharedInterface)
+      {
+        continue;
+      }
+      for (uint32_t j = 0; j < neighbourIpv4->GetNAddresses(i); j++)
+      {
+        Ipv4InterfaceAddress address = neighbourIpv4->GetAddress(i, j);
+        prefixes.push_back({address.GetLocal().CombineMask(address.GetMask()).Get(), address.GetMask().GetPrefixLength()});
+      }
+    }
+
+    // they share the gateway, so two halves of a prefix become the prefix
+    bool merged = true;
+    while (merged)
+    {
+      merged = false;
+      std::sort(prefixes.begin(), prefixes.end());
+      prefixes.erase(std::unique(prefixes.begin(), prefixes.end()), prefixes.end());
+      for (size_t i = 0; i + 1 < prefixes.size(); i++)
+      {
+        uint16_t length = prefixes[i].second;
+        if (length == 0 || prefixes[i + 1].second != length)
+        {
+          continue;
+        }
+        uint32_t half = 1u << (32 - length);
+        if ((prefixes[i].first & half) == 0 && prefixes[i + 1].first == (prefixes[i].first | half))
+        {
+          prefixes[i].second = length - 1;
+          prefixes.erase(prefixes.begin() + i + 1);
+          merged = true;
+        }
+      }
+    }
+
+    for (const std::pair<uint32_t, uint16_t> &prefix : prefixes)
+    {
+      uint32_t mask = prefix.second == 0 ? 0 : 0xffffffffu << (32 - prefix.second);
+      routing->AddNetworkRouteTo(Ipv4Address(prefix.first), Ipv4Mask(mask), route.gateway, interface);
+    }
+  }
+
   void IoTNet::UpdateAnimationInterface(AnimationInterface anim)
   {
     for (size_t i = 0; i < m_allNodes.GetN(); i++)
@@ -7,6 +7,11 @@
 #include "ns3/mobility-module.h"
 #include "ns3/netanim-module.h"
 
+#include "ns3/iotnet-telemetry-sink.h"
+#include "ns3/iotnet-codec.h"
+
+#include <unordered_map>
+
 namespace ns3
 {
   class IoTNet : public Object
@@ -14,20 +19,57 @@ namespace ns3
   public:
     static Ptr<IoTNet> world;
     Address address;
+    Ptr<IoTNetTelemetrySink> sink;
+    bool udp;
+    bool globalRouting;
+    IoTNetCodec::Format format;
 
     IoTNet();
     void Add(const std::string name, NodeContainer nodes, Vector position);
     void Add(const std::string name, NodeContainer nodes, Vector position, std::string icon);
     void Install();
+    void InstallRoutes();
+    void InstallMobility();
     void UpdateAnimationInterface(AnimationInterface anim);
+    void Emit(const std::string topic, const std::string record);
+    Ptr<Node> Find(const std::string name);
+    std::string GetName(Ptr<Node> node);
+
+    /**
+     * Static routes for the sensor -> AP -> router -> server tree, used
+     * unless globalRouting is set. They are recorded while the links are
+     * made and installed by InstallRoutes(), like the global routes. Leaves get a
+     * default route towards the server, the router covers the subnets behind
+     * each neighbour with as few prefixes as merge without loss.
+     *
+     * Every AP hangs off its own router link, so each cell has a different
+     * next hop and cells cannot share one covering prefix. With the usual
+     * single subnet per AP the router keeps one route per cell.
+     */
+    void SetDefaultRoute(Ptr<Node> node, Ptr<NetDevice> device, Ipv4Address gateway);
+    void AddRoutesBehind(Ptr<Node> node, Ptr<NetDevice> device, Ipv4Address gateway, Ptr<Node> neighbour, Ptr<NetDevice> neighbourDevice);
 
   private:
+    struct Route
+    {
+      Ptr<Node> node;
+      Ptr<NetDevice> device;
+      Ipv4Address gateway;
+      Ptr<Node> neighbour; // null for a default route
+      Ptr<NetDevice> neighbourDevice;
+    };
+
+    void InstallRoute(const Route &route);
+
+    std::vector<Route> m_routes;
     InternetStackHelper m_internet;
     MobilityHelper m_mobility;
     Ptr<ListPositionAllocator> m_positionAlloc;
     NodeContainer m_allNodes;
     std::vector<std::string> m_allNames;
     std::vector<std::string> m_allIcons;
+    std::unordered_map<std::string, size_t> m_nameIndex; // first node with the name
+    std::unordered_map<uint32_t, size_t> m_nodeIndex;     // node id to index
   };
 }
 
@@ -12,6 +12,11 @@
 #include "ns3/iotnet-wifi.h"
 #include "ns3/iotnet-server.h"
 #include "ns3/iotnet-router.h"
+#include "ns3/iotnet-telemetry-sink.h"
+#include "ns3/iotnet-scenario.h"
+
+#include <ctime>
+#include <fstream>
 
 NS_LOG_COMPONENT_DEFINE("IoTNetworkSimulation");
 
@@ -73,12 +78,24 @@ int main(int argc, char *argv[])
   NS_LOG_UNCOND("Setting something up");
 
   // settings
-  int nodeCount = 3;     // 2 normal [0, 1], 1 jammer [2]
   double duration = 30;  // seconds
   double interval = 0.1; // seconds
 
   bool realtime = false;
   bool jamming = false;
+  bool udp = false;
+  bool globalRouting = false;
+  bool deltaReports = false;
+  std::string format = "json"; // AP report wire format: json, cbor, msgpack
+
+  std::string scenarioPath = "src/iotnet/scenarios/home.json";
+  std::string outputDir = "output"; // animation, telemetry files and summary.json
+
+  std::string sinkType = "http";  // http, file, binfile, zmq, none
+  std::string sinkTarget = "";    // url, path or endpoint, empty for default
+  uint32_t exportCapacity = 4096;  // readings
+  uint32_t exportBatch = 32;       // readings per post
+  uint32_t exportInterval = 1000;  // milliseconds
 
   Time interPacketInterval = Seconds(interval);
 
@@ -91,8 +108,23 @@ int main(int argc, char *argv[])
   cmd.AddValue("duration", "Simulate duration", duration);
   cmd.AddValue("realtime", "Enable realtime mode", realtime);
   cmd.AddValue("jamming", "Enable jamming mode", jamming);
+  cmd.AddValue("scenario", "Scenario file describing the topology", scenarioPath);
+  cmd.AddValue("output", "Directory for the animation, telemetry files and summary", outputDir);
+  cmd.AddValue("globalRouting", "Use ns-3 global routing instead of the static tree routes", globalRouting);
+  cmd.AddValue("deltaReports", "APs only report sensors whose RSS or PDR changed", deltaReports);
+  cmd.AddValue("format", "AP report wire format: json, cbor or msgpack", format);
+  cmd.AddValue("udp", "Send readings as UDP datagrams instead of TCP", udp);
+  cmd.AddValue("sink", "Telemetry sink: http, file, binfile, zmq or none", sinkType);
+  cmd.AddValue("sinkTarget", "Telemetry sink url, file path or zmq endpoint", sinkTarget);
+  cmd.AddValue("exportCapacity", "Max readings queued for export", exportCapacity);
+  cmd.AddValue("exportBatch", "Readings per export post", exportBatch);
+  cmd.AddValue("exportInterval", "Export flush interval in milliseconds", exportInterval);
   cmd.Parse(argc, argv);
 
+  // the RNG run number comes from the standard --RngRun global value
+  uint64_t run = RngSeedManager::GetRun();
+  SystemPath::MakeDirectories(outputDir);
+
   // realtime
   if (realtime)
   {
@@ -101,89 +133,49 @@ int main(int argc, char *argv[])
 
   // global
   IoTNet::world = CreateObject<IoTNet>();
+  IoTNet::world->udp = udp;
+  IoTNet::world->globalRouting = globalRouting;
+  IoTNet::world->format = IoTNetCodec::FromName(format);
+
+  // reports are stamped with simulation time, offset to the start of the run
+  IoTNetWifi::deltaReports = deltaReports;
+  IoTNetWifi::epoch = int64_t(std::time(nullptr)) * 1000;
+
+  // telemetry
+  if (sinkType == "http")
+  {
+    IoTNet::world->sink = CreateObject<IoTNetHttpSink>(sinkTarget.empty() ? "server-node:3000/api/reading" : sinkTarget,
+                                                       exportCapacity, exportBatch, exportInterval);
+  }
+  else if (sinkType == "file" || sinkType == "binfile")
+  {
+    bool binary = sinkType == "binfile";
+    IoTNet::world->sink = CreateObject<IoTNetFileSink>(sinkTarget.empty() ? outputDir + (binary ? "/iotnet-telemetry.bin" : "/iotnet-telemetry.ndjson") : sinkTarget,
+                                                       binary);
+  }
+  else if (sinkType == "zmq")
+  {
+    IoTNet::world->sink = CreateObject<IoTNetZmqSink>(sinkTarget.empty() ? "tcp://server-node:5556" : sinkTarget, exportCapacity);
+  }
+  else if (sinkType != "none")
+  {
+    NS_FATAL_ERROR("Unknown telemetry sink " << sinkType);
+  }
 
-  // server
-  IoTNetServer server("server", "10.1.1.0", "255.255.255.0", Vector(50.0, 5.0, 0.0));
-
-  // wifi network
-  IoTNetWifi wifiPB("wifi-phong-bep", "10.1.3.0", "255.255.255.0", Vector(50.0, 40.0, 0.0));
-  Ptr<IoTNetNode> s1 = wifiPB.Create("may-nuoc-nong", Vector(55.0, 25.0, 0.0));
-  Ptr<IoTNetNode> s2 = wifiPB.Create("bep", Vector(40.0, 30.0, 0.0));
-  Ptr<IoTNetNode> s3 = wifiPB.Create("may-giat", Vector(45.0, 55.0, 0.0));
-  Ptr<IoTNetNode> s4 = wifiPB.Create("tu-lanh", Vector(55.0, 55.0, 0.0));
-  Ptr<IoTNetNode> j = wifiPB.Create("jammer", Vector(50.0, 50.0, 0.0));
-
-  IoTNetWifi wifiPK("wifi-phong-khach", "10.1.4.0", "255.255.255.0", Vector(15.0, 35.0, 0.0));
-  wifiPK.Create("bong-den", Vector(20.0, 20.0, 0.0));
-  wifiPK.Create("may-lanh", Vector(5.0, 25.0, 0.0));
-  wifiPK.Create("may-hut-bui", Vector(5.0, 45.0, 0.0));
-  wifiPK.Create("tivi", Vector(15.0, 50.0, 0.0));
-
-  IoTNetWifi wifiPN("wifi-phong-ngu", "10.1.5.0", "255.255.255.0", Vector(85.0, 35.0, 0.0));
-  wifiPN.Create("rem-cua", Vector(85.0, 25.0, 0.0));
-  wifiPN.Create("den-ban", Vector(75.0, 45.0, 0.0));
-  wifiPN.Create("dong-ho", Vector(90.0, 50.0, 0.0));
-
-  // old integrate
-  NodeContainer c, networkNodes;
-  c.Add(s1->node);
-  c.Add(s2->node);
-  c.Add(j->node);
-  networkNodes.Add(s1->node);
-  networkNodes.Add(s2->node);
-
-  // router
-  IoTNetRouter router("router", "10.1.2.0", "255.255.255.0", Vector(50.0, 15.0, 0.0));
-  server.Add(router.GetNode());
-
-  NodeContainer apNodes;
-  apNodes.Add(wifiPK.GetAp()->node);
-  apNodes.Add(wifiPB.GetAp()->node);
-  apNodes.Add(wifiPN.GetAp()->node);
-  router.Add(apNodes);
-
-  IoTNet::world->address = server.GetAddress();
-
-  NetDeviceContainer devices, jammerNetdevice;
-  devices.Add(s1->device);
-  devices.Add(s2->device);
-  jammerNetdevice.Add(j->device);
-
-  // wireless utility
-  WirelessModuleUtilityHelper utilityHelper;
-  std::vector<std::string> AllInclusionList;
-  std::vector<std::string> AllExclusionList;
-  utilityHelper.SetInclusionList(AllInclusionList);
-  utilityHelper.SetExclusionList(AllExclusionList);
-  WirelessModuleUtilityContainer utilities = utilityHelper.InstallAll();
-
-  Ptr<WirelessModuleUtility> utilitySend = utilities.Get(0);    // node 0
-  Ptr<WirelessModuleUtility> utilityReceive = utilities.Get(1); // node 1
-
-  // jammer
-  JammerHelper jammerHelper;
-  jammerHelper.SetJammerType("ns3::ReactiveJammer");
-  jammerHelper.Set("ReactiveJammerRxTimeout", TimeValue(Seconds(2.0)));
-  jammerHelper.Set("ReactiveJammerReactionStrategy",
-                   UintegerValue(ReactiveJammer::FIXED_PROBABILITY));
-  JammerContainer jammers = jammerHelper.Install(c.Get(nodeCount - 1));
-  Ptr<Jammer> jammerPtr = jammers.Get(0);
-
-  // jamming mitigation
-  // JammingMitigationHelper mitigationHelper;
-  // mitigationHelper.SetJammingMitigationType("ns3::MitigateByChannelHop");
-  // mitigationHelper.Set("MitigateByChannelHopChannelHopDelay",
-  //                      TimeValue(Seconds(0.0)));
-  // mitigationHelper.Set("MitigateByChannelHopDetectionMethod",
-  //                      UintegerValue(MitigateByChannelHop::PDR_ONLY));
-  // JammingMitigationContainer mitigators = mitigationHelper.Install(networkNodes); // normal
-  // Ptr<JammingMitigation> mitigationPtr = mitigators.Get(1);                       // node 1
-  // Ptr<JammingMitigation> mitigationPtr2 = mitigators.Get(0);                      // node 0
+  // topology
+  Ptr<IoTNetScenario> scenario = CreateObject<IoTNetScenario>(scenarioPath);
+  scenario->Build();
+
+  Ptr<WirelessModuleUtility> utilitySend = scenario->GetSender();
+  Ptr<WirelessModuleUtility> utilityReceive = scenario->GetReceiver();
+
+  std::ofstream footprintFile(outputDir + "/footprint.csv");
+  scenario->PrintFootprint(footprintFile);
 
   // Install
   IoTNet::world->Install();
 
-  AnimationInterface anim("output/iotnet-anim.xml");
+  AnimationInterface anim(outputDir + "/iotnet-anim.xml");
   anim.EnablePacketMetadata();
   if (!jamming)
   {
@@ -196,10 +188,7 @@ int main(int argc, char *argv[])
   // IoTNet::world->UpdateAnimationInterface(anim);
 
   // schedule
-  if (jamming)
-  {
-    Simulator::Schedule(Seconds(2), &ns3::Jammer::StartJammer, jammerPtr); // start jammer at 2s
-  }
+  scenario->Start(jamming); // jammers only start in jamming mode
 
   // Simulator::Schedule(Seconds(0.1), NodePdr, utilitySend, duration);
   // Simulator::Schedule(Seconds(0.1), NodePdr, utilityReceive, duration);
@@ -213,9 +202,12 @@ int main(int argc, char *argv[])
 
   // simulation
   NS_LOG_UNCOND(">> Start simulation");
+  if (IoTNet::world->sink)
+  {
+    IoTNet::world->sink->Start();
+  }
   Simulator::Stop(Seconds(duration));
   Simulator::Run();
-  Simulator::Destroy();
   NS_LOG_UNCOND("<< Stop simulation");
 
   // information
@@ -224,5 +216,29 @@ int main(int argc, char *argv[])
   NS_LOG_UNCOND("Total Byte Received = " << utilityReceive->GetTotalBytesRx());
   NS_LOG_UNCOND("Total Byte Sent = " << utilitySend->GetTotalBytesTx());
 
+  std::stringstream summary;
+  summary << "{\"run\":" << run
+          << ",\"pdr\":" << utilityReceive->GetPdr()
+          << ",\"valid\":" << utilityReceive->GetValidPkts()
+          << ",\"total\":" << utilityReceive->GetTotalPkts()
+          << ",\"bytesRx\":" << utilityReceive->GetTotalBytesRx()
+          << ",\"bytesTx\":" << utilitySend->GetTotalBytesTx() << "}";
+  IoTNet::world->Emit("summary", summary.str());
+
+  // read back by utils/sweep.py
+  std::ofstream summaryFile(outputDir + "/summary.json");
+  summaryFile << summary.str() << std::endl;
+
+  // records carry Simulator::Now, destroying resets it to zero
+  Simulator::Destroy();
+
+  if (IoTNet::world->sink)
+  {
+    IoTNet::world->sink->Stop();
+    std::stringstream stats;
+    IoTNet::world->sink->PrintStats(stats);
+    NS_LOG_UNCOND("Telemetry " << sinkType << ": " << stats.str());
+  }
+
   return 0;
 }
\ No newline at end of file
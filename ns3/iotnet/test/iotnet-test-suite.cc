@@ -2,10 +2,24 @@
 
 // Include a header file from your module to test.
 #include "ns3/iotnet.h"
+#include "ns3/iotnet-exporter.h"
+#include "ns3/iotnet-telemetry-sink.h"
+#include "ns3/iotnet-scenario.h"
+#include "ns3/iotnet-helper.h"
+#include "ns3/iotnet-codec.h"
+#include "ns3/iotnet-frame-buffer.h"
+#include "ns3/iotnet-connection.h"
+#include "ns3/iotnet-wifi.h"
+#include "ns3/point-to-point-helper.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
 
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <map>
+
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
 using namespace ns3;
@@ -46,6 +60,585 @@ IotnetTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+// Exporter test case: a mock HTTP sink records every posted batch.
+class IotnetExporterTestCase : public TestCase
+{
+public:
+  IotnetExporterTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IotnetExporterTestCase::IotnetExporterTestCase ()
+  : TestCase ("Iotnet exporter batches readings and counts drops")
+{
+}
+
+void
+IotnetExporterTestCase::DoRun (void)
+{
+  std::mutex mutex;
+  std::vector<std::string> bodies;
+  IoTNetExporter::PostFunction sink = [&] (const std::string &body) {
+    std::lock_guard<std::mutex> lock (mutex);
+    bodies.push_back (body);
+    return true;
+  };
+
+  // the sender is not started yet, so the queue fills deterministically
+  Ptr<IoTNetExporter> exporter = CreateObject<IoTNetExporter> (sink, 4, 3, 10);
+  for (int i = 0; i < 6; i++)
+    {
+      exporter->Push ("{\"i\":" + std::to_string (i) + "}");
+    }
+  NS_TEST_ASSERT_MSG_EQ (exporter->GetPushed (), 4, "queue should accept up to its capacity");
+  NS_TEST_ASSERT_MSG_EQ (exporter->GetDropped (), 2, "readings past capacity should be dropped");
+  NS_TEST_ASSERT_MSG_EQ (exporter->GetBackpressure (), 1, "pushes above 3/4 full should be counted");
+
+  exporter->Start ();
+  exporter->Stop ();
+
+  NS_TEST_ASSERT_MSG_EQ (exporter->GetQueued (), 0, "stop should drain the queue");
+  NS_TEST_ASSERT_MSG_EQ (exporter->GetSent (), 4, "every queued reading should be sent");
+  NS_TEST_ASSERT_MSG_EQ (bodies.size (), 2, "4 readings with batch size 3 make 2 posts");
+  NS_TEST_ASSERT_MSG_EQ (bodies[0], "[{\"i\":0},{\"i\":1},{\"i\":2}]", "batch should be a JSON array");
+  NS_TEST_ASSERT_MSG_EQ (bodies[1], "[{\"i\":3}]", "remainder should be flushed on stop");
+}
+
+// File sink test case: records are appended one JSON document per line.
+class IotnetFileSinkTestCase : public TestCase
+{
+public:
+  IotnetFileSinkTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IotnetFileSinkTestCase::IotnetFileSinkTestCase ()
+  : TestCase ("Iotnet file sink writes NDJSON records")
+{
+}
+
+void
+IotnetFileSinkTestCase::DoRun (void)
+{
+  std::string path = CreateTempDirFilename ("telemetry.ndjson");
+  Ptr<IoTNetFileSink> sink = CreateObject<IoTNetFileSink> (path, false);
+  sink->Write ("reading", "{\"ap\":\"a\"}");
+  sink->Write ("energy", "{\"node\":\"b\"}");
+  sink->Stop ();
+
+  std::ifstream file (path);
+  std::string line;
+  std::getline (file, line);
+  NS_TEST_ASSERT_MSG_EQ (line, "{\"topic\":\"reading\",\"at\":0,\"data\":{\"ap\":\"a\"}}", "first record");
+  std::getline (file, line);
+  NS_TEST_ASSERT_MSG_EQ (line, "{\"topic\":\"energy\",\"at\":0,\"data\":{\"node\":\"b\"}}", "second record");
+  NS_TEST_ASSERT_MSG_EQ (std::getline (file, line).good (), false, "no more records");
+}
+
+// Scenario files are parsed into a description with defaults filled in
+class IotnetScenarioTestCase : public TestCase
+{
+public:
+  IotnetScenarioTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IotnetScenarioTestCase::IotnetScenarioTestCase ()
+  : TestCase ("Iotnet scenario parsing")
+{
+}
+
+void
+IotnetScenarioTestCase::DoRun (void)
+{
+  IoTNetScenario::Description d = IoTNetScenario::Parse (
+    "{\"server\": {\"id\": \"srv\", \"network\": \"10.1.1.0\", \"position\": [1, 2]},"
+    " \"router\": {\"id\": \"rt\", \"network\": \"10.1.2.0\", \"mask\": \"255.255.0.0\", \"position\": [0, 0, 0]},"
+    " \"wifi\": [{\"id\": \"a\", \"network\": \"10.1.3.0\", \"position\": [0, 0, 0],"
+    "            \"sensors\": [{\"id\": \"s\", \"position\": [3, 4, 5]}]},"
+    "           {\"id\": \"b\", \"network\": \"10.1.4.0\", \"position\": [0, 0, 0]}],"
+    " \"jammers\": [{\"node\": \"s\", \"type\": \"ns3::ReactiveJammer\", \"start\": 2,"
+    "               \"attributes\": {\"ReactiveJammerRxTimeout\": \"2s\", \"ReactiveJammerReactionStrategy\": 1}}],"
+    " \"traffic\": [{\"node\": \"s\", \"interval\": 0.5}],"
+    " \"utilities\": {\"cells\": [\"b\"], \"nodes\": [\"s*\"]}}");
+
+  NS_TEST_ASSERT_MSG_EQ (d.name, "scenario", "default name");
+  NS_TEST_ASSERT_MSG_EQ (d.server.id, "srv", "server id");
+  NS_TEST_ASSERT_MSG_EQ (d.server.mask, Ipv4Mask ("255.255.255.0"), "default mask");
+  NS_TEST_ASSERT_MSG_EQ (d.server.position, Vector (1, 2, 0), "2d position");
+  NS_TEST_ASSERT_MSG_EQ (d.router.mask, Ipv4Mask ("255.255.0.0"), "router mask");
+  NS_TEST_ASSERT_MSG_EQ (d.wifi.size (), 2, "wifi cells");
+  NS_TEST_ASSERT_MSG_EQ (d.wifi[0].sensors.size (), 1, "sensors");
+  NS_TEST_ASSERT_MSG_EQ (d.wifi[0].sensors[0].position, Vector (3, 4, 5), "sensor position");
+  NS_TEST_ASSERT_MSG_EQ (d.links.size (), 2, "router links default to every cell");
+  NS_TEST_ASSERT_MSG_EQ (d.links[1], "b", "links in file order");
+  NS_TEST_ASSERT_MSG_EQ (d.jammers.size (), 1, "jammers");
+  NS_TEST_ASSERT_MSG_EQ (d.jammers[0].nodes[0], "s", "jammer node");
+  NS_TEST_ASSERT_MSG_EQ (d.jammers[0].attributes["ReactiveJammerRxTimeout"], "2s", "string attribute");
+  NS_TEST_ASSERT_MSG_EQ (d.jammers[0].attributes["ReactiveJammerReactionStrategy"], "1", "number attribute");
+  NS_TEST_ASSERT_MSG_EQ (d.mitigators.size (), 0, "no mitigators");
+  NS_TEST_ASSERT_MSG_EQ (d.traffic[0].start, 1.0, "default traffic start");
+  NS_TEST_ASSERT_MSG_EQ (d.traffic[0].interval, 0.5, "traffic interval");
+  NS_TEST_ASSERT_MSG_EQ (d.sender, "", "no metrics");
+  NS_TEST_ASSERT_MSG_EQ (d.utilities.all, false, "utilities only where selected");
+  NS_TEST_ASSERT_MSG_EQ (d.utilities.cells[0], "b", "utility cell");
+  NS_TEST_ASSERT_MSG_EQ (d.utilities.nodes[0], "s*", "utility name pattern");
+  NS_TEST_ASSERT_MSG_EQ (WirelessModuleUtilityHelper::MatchName ("s*", "s"), true, "star matches empty");
+  NS_TEST_ASSERT_MSG_EQ (WirelessModuleUtilityHelper::MatchName ("wifi-?", "wifi-ab"), false, "? matches one character");
+}
+
+// Generated topologies keep ids and subnets unique past a /16 of rooms
+class IotnetTopologyTestCase : public TestCase
+{
+public:
+  IotnetTopologyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IotnetTopologyTestCase::IotnetTopologyTestCase ()
+  : TestCase ("Iotnet generated topology addressing")
+{
+}
+
+void
+IotnetTopologyTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (IoTNetHelper::Subnet ("10.16.0.0", "255.255.255.0", 255), Ipv4Address ("10.16.255.0"), "last /24 of the octet");
+  NS_TEST_ASSERT_MSG_EQ (IoTNetHelper::Subnet ("10.16.0.0", "255.255.255.0", 256), Ipv4Address ("10.17.0.0"), "carry into the next octet");
+  NS_TEST_ASSERT_MSG_EQ (IoTNetHelper::Subnet ("10.2.0.0", "255.255.255.252", 3), Ipv4Address ("10.2.0.12"), "/30 links");
+
+  IoTNetHelper helper;
+  IoTNetScenario::Description d = helper.Generate (30, 10, 3);
+  NS_TEST_ASSERT_MSG_EQ (d.wifi.size (), 300, "one cell per room");
+  NS_TEST_ASSERT_MSG_EQ (d.links.size (), 300, "every cell linked to the router");
+  NS_TEST_ASSERT_MSG_EQ (d.wifi[299].network, Ipv4Address ("10.17.43.0"), "room 299 past 10.16.255.0");
+  NS_TEST_ASSERT_MSG_EQ (d.wifi[299].sensors.size (), 3, "sensors per room");
+  NS_TEST_ASSERT_MSG_EQ (d.wifi[299].sensors[2].id, "b29-r9-s2", "sensor id");
+}
+
+// Binary wire formats convert back to the same JSON document
+class IotnetCodecTestCase : public TestCase
+{
+public:
+  IotnetCodecTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IotnetCodecTestCase::IotnetCodecTestCase ()
+  : TestCase ("Iotnet report wire formats")
+{
+}
+
+void
+IotnetCodecTestCase::DoRun (void)
+{
+  nlohmann::json report = {{"ap", "a"}, {"at", 1500}, {"sensors", {{{"name", "s"}, {"rssi", {140.5}}, {"pdr", {0.25}}}}}};
+  std::string text = report.dump ();
+
+  for (IoTNetCodec::Format format : {IoTNetCodec::JSON, IoTNetCodec::CBOR, IoTNetCodec::MSGPACK})
+    {
+      std::string bytes = IoTNetCodec::Encode (report, format);
+      std::string decoded;
+      NS_TEST_ASSERT_MSG_EQ (IoTNetCodec::ToJson (reinterpret_cast<const uint8_t *> (bytes.data ()), bytes.size (), format, decoded),
+                             true, IoTNetCodec::GetName (format) << " decodes");
+      NS_TEST_ASSERT_MSG_EQ (decoded, text, IoTNetCodec::GetName (format) << " round trip");
+      NS_TEST_ASSERT_MSG_EQ (IoTNetCodec::FromName (IoTNetCodec::GetName (format)), format, "name round trip");
+      if (format != IoTNetCodec::JSON)
+        {
+          NS_TEST_ASSERT_MSG_LT (bytes.size (), text.size (), IoTNetCodec::GetName (format) << " is smaller than JSON");
+        }
+    }
+
+  std::string decoded;
+  const uint8_t garbage[] = {0xff, 0x01};
+  NS_TEST_ASSERT_MSG_EQ (IoTNetCodec::ToJson (garbage, sizeof (garbage), IoTNetCodec::CBOR, decoded), false, "invalid CBOR");
+}
+
+// Frames split over or packed into receives come out whole
+class IotnetFrameBufferTestCase : public TestCase
+{
+public:
+  IotnetFrameBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IotnetFrameBufferTestCase::IotnetFrameBufferTestCase ()
+  : TestCase ("Iotnet frame reassembly")
+{
+}
+
+void
+IotnetFrameBufferTestCase::DoRun (void)
+{
+  std::string stream = IoTNetFrameBuffer::Frame ("first") + IoTNetFrameBuffer::Frame ("") + IoTNetFrameBuffer::Frame (std::string (300, 'x'));
+  IoTNetFrameBuffer frames (1024);
+  std::vector<std::string> received;
+  const uint8_t *data;
+  uint32_t size;
+
+  // feed 7 bytes at a time, headers and payloads get cut anywhere
+  for (size_t offset = 0; offset < stream.size (); offset += 7)
+    {
+      std::string chunk = stream.substr (offset, 7);
+      frames.Append (Create<Packet> (reinterpret_cast<const uint8_t *> (chunk.data ()), chunk.size ()));
+      while (frames.Next (data, size))
+        {
+          received.push_back (std::string (reinterpret_cast<const char *> (data), size));
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (received.size (), 3, "three frames");
+  NS_TEST_ASSERT_MSG_EQ (received[0], "first", "first frame");
+  NS_TEST_ASSERT_MSG_EQ (received[1], "", "empty frame");
+  NS_TEST_ASSERT_MSG_EQ (received[2], std::string (300, 'x'), "frame split over many chunks");
+  NS_TEST_ASSERT_MSG_EQ (frames.GetBuffered (), 0, "nothing left over");
+
+  // all of them in one chunk
+  received.clear ();
+  frames.Append (Create<Packet> (reinterpret_cast<const uint8_t *> (stream.data ()), stream.size ()));
+  while (frames.Next (data, size))
+    {
+      received.push_back (std::string (reinterpret_cast<const char *> (data), size));
+    }
+  NS_TEST_ASSERT_MSG_EQ (received.size (), 3, "coalesced frames");
+
+  // a length above the limit marks the stream corrupt
+  std::string oversized = IoTNetFrameBuffer::Frame (std::string (2048, 'y'));
+  frames.Append (Create<Packet> (reinterpret_cast<const uint8_t *> (oversized.data ()), oversized.size ()));
+  NS_TEST_ASSERT_MSG_EQ (frames.Next (data, size), false, "oversized frame rejected");
+  NS_TEST_ASSERT_MSG_EQ (frames.IsCorrupt (), true, "stream corrupt");
+}
+
+// A frame larger than the TCP send buffer is written in pieces and does not
+// hold back the frames queued behind it
+class IotnetConnectionTestCase : public TestCase
+{
+public:
+  IotnetConnectionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Accept (Ptr<Socket> socket, const Address &from);
+  void Receive (Ptr<Socket> socket);
+
+  IoTNetFrameBuffer m_frames;
+  std::vector<std::string> m_received;
+};
+
+IotnetConnectionTestCase::IotnetConnectionTestCase ()
+  : TestCase ("Iotnet connection sends frames larger than the send buffer")
+{
+}
+
+void
+IotnetConnectionTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&IotnetConnectionTestCase::Receive, this));
+}
+
+void
+IotnetConnectionTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  const uint8_t *data;
+  uint32_t size;
+  while ((packet = socket->Recv ()))
+    {
+      m_frames.Append (packet);
+      while (m_frames.Next (data, size))
+        {
+          m_received.push_back (std::string (reinterpret_cast<const char *> (data), size));
+        }
+    }
+}
+
+void
+IotnetConnectionTestCase::DoRun (void)
+{
+  uint32_t sndBufSize = 16 * 1024;
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (sndBufSize));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = p2p.Install (nodes);
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Ptr<Socket> listener = Socket::CreateSocket (nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9000));
+  listener->Listen ();
+  listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                               MakeCallback (&IotnetConnectionTestCase::Accept, this));
+
+  Ptr<IoTNetConnection> connection = CreateObject<IoTNetConnection> (nodes.Get (0), InetSocketAddress (interfaces.GetAddress (1), 9000), false);
+  std::string large (4 * sndBufSize, 'x');
+  connection->Send (large);
+  connection->Send ("after");
+
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 2, "both frames delivered");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0] == large, true, "large frame arrives whole");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], "after", "queued frame follows");
+  NS_TEST_ASSERT_MSG_EQ (connection->GetSent (), 2, "both frames counted as sent");
+  NS_TEST_ASSERT_MSG_EQ (connection->GetQueued (), 0, "queue drained");
+
+  connection->Close ();
+  listener->Close ();
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+class IotnetConnectionOversizeTestCase : public TestCase
+{
+public:
+  IotnetConnectionOversizeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Accept (Ptr<Socket> socket, const Address &from);
+  void Receive (Ptr<Socket> socket);
+
+  std::map<Ptr<Socket>, IoTNetFrameBuffer> m_frames;
+  std::vector<std::string> m_received;
+};
+
+IotnetConnectionOversizeTestCase::IotnetConnectionOversizeTestCase ()
+  : TestCase ("Iotnet connection drops records the server cannot accept")
+{
+}
+
+void
+IotnetConnectionOversizeTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&IotnetConnectionOversizeTestCase::Receive, this));
+}
+
+void
+IotnetConnectionOversizeTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  const uint8_t *data;
+  uint32_t size;
+  IoTNetFrameBuffer &frames = m_frames[socket];
+  while ((packet = socket->Recv ()))
+    {
+      frames.Append (packet);
+      while (frames.Next (data, size))
+        {
+          m_received.push_back (std::string (reinterpret_cast<const char *> (data), size));
+        }
+      if (socket->GetSocketType () == Socket::NS3_SOCK_DGRAM)
+        {
+          // every datagram holds whole frames
+          frames.Clear ();
+        }
+    }
+}
+
+void
+IotnetConnectionOversizeTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = p2p.Install (nodes);
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Ptr<Socket> listener = Socket::CreateSocket (nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9000));
+  listener->Listen ();
+  listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                               MakeCallback (&IotnetConnectionOversizeTestCase::Accept, this));
+  Ptr<Socket> datagrams = Socket::CreateSocket (nodes.Get (1), UdpSocketFactory::GetTypeId ());
+  datagrams->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9001));
+  datagrams->SetRecvCallback (MakeCallback (&IotnetConnectionOversizeTestCase::Receive, this));
+
+  Ptr<IoTNetConnection> tcp = CreateObject<IoTNetConnection> (nodes.Get (0), InetSocketAddress (interfaces.GetAddress (1), 9000), false);
+  tcp->Send (std::string (IoTNetFrameBuffer::defaultMaxFrameSize + 1, 'x'));
+  tcp->Send ("tcp");
+  NS_TEST_ASSERT_MSG_EQ (tcp->GetDropped (), 1, "record over the frame limit dropped");
+  NS_TEST_ASSERT_MSG_EQ (tcp->GetQueued (), 1, "only the small record queued");
+
+  Ptr<IoTNetConnection> udp = CreateObject<IoTNetConnection> (nodes.Get (0), InetSocketAddress (interfaces.GetAddress (1), 9001), true);
+  udp->Send (std::string (IoTNetConnection::maxDatagramSize - IoTNetFrameBuffer::headerSize + 1, 'x'));
+  udp->Send ("udp");
+  NS_TEST_ASSERT_MSG_EQ (udp->GetDropped (), 1, "frame over one datagram dropped");
+
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 2, "records behind the dropped ones delivered");
+  NS_TEST_ASSERT_MSG_EQ (std::count (m_received.begin (), m_received.end (), "tcp"), 1, "tcp record delivered");
+  NS_TEST_ASSERT_MSG_EQ (std::count (m_received.begin (), m_received.end (), "udp"), 1, "udp record delivered");
+  NS_TEST_ASSERT_MSG_EQ (tcp->GetConnects (), 1, "server kept the connection open");
+  NS_TEST_ASSERT_MSG_EQ (tcp->GetQueued (), 0, "tcp queue drained");
+  NS_TEST_ASSERT_MSG_EQ (udp->GetQueued (), 0, "udp queue drained");
+
+  tcp->Close ();
+  udp->Close ();
+  listener->Close ();
+  datagrams->Close ();
+  Simulator::Destroy ();
+}
+
+// Delta reports of an AP: a keyframe with every sensor at the start and every
+// reportInterval, in between only the sensors whose RSS moved, and a sequence
+// number that keeps counting when the server drops the connection
+class IotnetDeltaReportTestCase : public TestCase
+{
+public:
+  IotnetDeltaReportTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Accept (Ptr<Socket> socket, const Address &from);
+  void Receive (Ptr<Socket> socket);
+  void Disconnect (void);
+
+  std::map<Ptr<Socket>, IoTNetFrameBuffer> m_frames;
+  std::vector<Ptr<Socket> > m_accepted;
+  std::vector<nlohmann::json> m_reports;
+};
+
+IotnetDeltaReportTestCase::IotnetDeltaReportTestCase ()
+  : TestCase ("Iotnet delta reports, keyframes and sequence numbers")
+{
+}
+
+void
+IotnetDeltaReportTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  m_accepted.push_back (socket);
+  socket->SetRecvCallback (MakeCallback (&IotnetDeltaReportTestCase::Receive, this));
+}
+
+void
+IotnetDeltaReportTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  const uint8_t *data;
+  uint32_t size;
+  IoTNetFrameBuffer &frames = m_frames[socket];
+  while ((packet = socket->Recv ()))
+    {
+      frames.Append (packet);
+      while (frames.Next (data, size))
+        {
+          m_reports.push_back (nlohmann::json::parse (std::string (reinterpret_cast<const char *> (data), size)));
+        }
+    }
+}
+
+void
+IotnetDeltaReportTestCase::Disconnect (void)
+{
+  m_accepted.back ()->Close ();
+}
+
+void
+IotnetDeltaReportTestCase::DoRun (void)
+{
+  bool deltaReports = IoTNetWifi::deltaReports;
+  Time reportInterval = IoTNetWifi::reportInterval;
+  Time deltaInterval = IoTNetWifi::deltaInterval;
+  IoTNetWifi::deltaReports = true;
+  IoTNetWifi::reportInterval = Seconds (5);
+  IoTNetWifi::deltaInterval = Seconds (1);
+  // no beacons, nothing else on the air changes the sensors' RSS
+  Config::SetDefault ("ns3::ApWifiMac::BeaconGeneration", BooleanValue (false));
+
+  IoTNet::world = CreateObject<IoTNet> ();
+  IoTNetWifi wifi ("ap", "10.1.3.0", "255.255.255.0", Vector (0, 0, 0));
+  Ptr<IoTNetNode> sensors[] = {wifi.Create ("s1", Vector (5, 0, 0)), wifi.Create ("s2", Vector (0, 5, 0))};
+  WirelessModuleUtilityHelper utilityHelper;
+  utilityHelper.Install (sensors[0]->node);
+  utilityHelper.Install (sensors[1]->node);
+
+  NodeContainer server;
+  server.Create (1);
+  IoTNet::world->Add ("server", server, Vector (50, 0, 0));
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = p2p.Install (wifi.GetAp ()->node.Get (0), server.Get (0));
+  Ipv4AddressHelper address ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  IoTNet::world->address = InetSocketAddress (interfaces.GetAddress (1), 9000);
+  IoTNet::world->Install ();
+
+  Ptr<Socket> listener = Socket::CreateSocket (server.Get (0), TcpSocketFactory::GetTypeId ());
+  listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9000));
+  listener->Listen ();
+  listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                               MakeCallback (&IotnetDeltaReportTestCase::Accept, this));
+
+  // samples every second from 1 s, keyframes at 1, 6 and 11 s; a noise
+  // figure 6 dB up moves a sensor's RSS by as much
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<NslWifiPhy> phy = DynamicCast<NslWifiPhy> (DynamicCast<WifiNetDevice> (sensors[i]->device.Get (0))->GetPhy ());
+      Simulator::Schedule (Seconds (3.5 + 4 * i), &WifiPhy::SetRxNoiseFigure, phy, phy->GetRxNoiseFigure () + 6);
+    }
+  Simulator::Schedule (Seconds (6.3), &IotnetDeltaReportTestCase::Disconnect, this);
+  Simulator::Stop (Seconds (11.5));
+  Simulator::Run ();
+
+  int64_t at[] = {1000, 4000, 6000, 8000, 11000};
+  bool keyframe[] = {true, false, true, false, true};
+  const char *changed[] = {"", "s1", "", "s2", ""};
+  NS_TEST_ASSERT_MSG_EQ (m_reports.size (), 5, "three keyframes and two deltas, samples without changes send nothing");
+  for (size_t i = 0; i < m_reports.size () && i < 5; i++)
+    {
+      const nlohmann::json &report = m_reports[i];
+      NS_TEST_ASSERT_MSG_EQ (report["seq"].get<uint32_t> (), i, "report " << i << " sequence number");
+      NS_TEST_ASSERT_MSG_EQ (report["at"].get<int64_t> (), at[i], "report " << i << " time");
+      NS_TEST_ASSERT_MSG_EQ (report["keyframe"].get<bool> (), keyframe[i], "report " << i << " keyframe flag");
+      if (keyframe[i])
+        {
+          NS_TEST_ASSERT_MSG_EQ (report["sensors"].size (), 2, "keyframe " << i << " holds every sensor");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (report["sensors"].size (), 1, "delta " << i << " holds the changed sensor only");
+          NS_TEST_ASSERT_MSG_EQ (report["sensors"][0]["name"].get<std::string> (), changed[i], "delta " << i << " sensor");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_accepted.size (), 2, "reports after the disconnect came over a new connection");
+  NS_TEST_ASSERT_MSG_EQ (wifi.GetAp ()->connection->GetConnects (), 2, "AP reconnected once");
+
+  wifi.GetAp ()->connection->Close ();
+  listener->Close ();
+  Simulator::Destroy ();
+  IoTNet::world = nullptr;
+  IoTNetWifi::deltaReports = deltaReports;
+  IoTNetWifi::reportInterval = reportInterval;
+  IoTNetWifi::deltaInterval = deltaInterval;
+  Config::Reset ();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +654,15 @@ IotnetTestSuite::IotnetTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new IotnetTestCase1, TestCase::QUICK);
+  AddTestCase (new IotnetExporterTestCase, TestCase::QUICK);
+  AddTestCase (new IotnetFileSinkTestCase, TestCase::QUICK);
+  AddTestCase (new IotnetScenarioTestCase, TestCase::QUICK);
+  AddTestCase (new IotnetTopologyTestCase, TestCase::QUICK);
+  AddTestCase (new IotnetCodecTestCase, TestCase::QUICK);
+  AddTestCase (new IotnetFrameBufferTestCase, TestCase::QUICK);
+  AddTestCase (new IotnetConnectionTestCase, TestCase::QUICK);
+  AddTestCase (new IotnetConnectionOversizeTestCase, TestCase::QUICK);
+  AddTestCase (new IotnetDeltaReportTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+"""
+Parameter sweep for the iotnet simulation.
+
+Every combination of the --param values is run --runs times, each run with
+its own RNG run number and output directory (animation, telemetry files and
+summary.json). Runs are independent processes spread over --jobs workers,
+the built binary is started directly so runs do not serialize on the waf lock.
+When all runs are done their summaries are merged into one CSV.
+
+Run from the ns-3 root after ./waf build:
+
+    python3 src/iotnet/utils/sweep.py --runs 10 \\
+        --param duration=30,60 --param jamming=false,true \\
+        --param ns3::ReactiveJammer::ReactiveJammerFixedProbability=0.2,0.5
+
+Parameters are passed to the binary as --name=value, so ns-3 attribute
+defaults work the same way as the simulation's own options.
+"""
+
+import argparse
+import csv
+import itertools
+import json
+import os
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+SUMMARY_FIELDS = ['pdr', 'valid', 'total', 'bytesRx', 'bytesTx']
+
+
+def parse_params(values):
+    params = []
+    for value in values:
+        if '=' not in value:
+            sys.exit('--param expects name=v1,v2,..., got ' + value)
+        name, choices = value.split('=', 1)
+        params.append((name, choices.split(',')))
+    return params
+
+
+def run_dir_name(index, combination, run):
+    label = '-'.join('%s=%s' % (name.split('::')[-1], value) for name, value in combination)
+    return '%04d-%s-run%d' % (index, label or 'default', run)
+
+
+def simulate(binary, env, output, combination, run, extra, timeout):
+    os.makedirs(output, exist_ok=True)
+    summary_path = os.path.join(output, 'summary.json')
+    if os.path.exists(summary_path):
+        os.remove(summary_path)  # left over from an earlier sweep
+
+    args = [binary, '--RngRun=%d' % run, '--output=%s' % output]
+    args += ['--%s=%s' % (name, value) for name, value in combination]
+    args += extra
+
+    started = time.time()
+    with open(os.path.join(output, 'stdout.log'), 'w') as log:
+        try:
+            status = subprocess.call(args, stdout=log, stderr=subprocess.STDOUT, env=env, timeout=timeout)
+        except subprocess.TimeoutExpired:
+            status = 'timeout'
+    elapsed = time.time() - started
+
+    row = {'dir': output, 'run': run, 'status': status, 'seconds': '%.3f' % elapsed}
+    row.update(dict(combination))
+    try:
+        with open(summary_path) as summary:
+            result = json.load(summary)
+        for field in SUMMARY_FIELDS:
+            row[field] = result.get(field)
+    except (OSError, ValueError):
+        pass
+    return row
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--binary', default='build/scratch/iotnet/iotnet', help='simulation binary')
+    parser.add_argument('--param', action='append', default=[], help='name=v1,v2,... swept value list')
+    parser.add_argument('--runs', type=int, default=1, help='RNG runs per combination')
+    parser.add_argument('--first-run', type=int, default=1, help='first RNG run number')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='parallel simulations')
+    parser.add_argument('--output', default='output/sweep', help='sweep directory')
+    parser.add_argument('--csv', default=None, help='merged results, default <output>/results.csv')
+    parser.add_argument('--timeout', type=float, default=None, help='seconds before a run is killed')
+    # anything else, e.g. --sink=file, is passed to every run unchanged
+    options, extra = parser.parse_known_args()
+
+    if not os.path.exists(options.binary):
+        sys.exit('%s not found, run ./waf build first' % options.binary)
+
+    # the binary links against build/lib, as ./waf --run would set it up
+    env = dict(os.environ)
+    lib = os.path.abspath(os.path.join(os.path.dirname(options.binary), '..', '..', 'lib'))
+    env['LD_LIBRARY_PATH'] = lib + os.pathsep + env.get('LD_LIBRARY_PATH', '')
+
+    # sweeps never post to the web server unless asked to
+    if not any(arg.startswith('--sink=') for arg in extra):
+        extra = extra + ['--sink=none']
+
+    params = parse_params(options.param)
+    names = [name for name, _ in params]
+    combinations = list(itertools.product(*[[(name, value) for value in values] for name, values in params]))
+
+    jobs = []
+    for index, combination in enumerate(combinations):
+        for run in range(options.first_run, options.first_run + options.runs):
+            output = os.path.join(options.output, run_dir_name(index, combination, run))
+            jobs.append((output, combination, run))
+
+    print('%d combinations x %d runs = %d simulations on %d workers' %
+          (len(combinations), options.runs, len(jobs), options.jobs))
+
+    rows = []
+    with ThreadPoolExecutor(max_workers=options.jobs) as pool:
+        futures = [pool.submit(simulate, options.binary, env, output, combination, run, extra, options.timeout)
+                   for output, combination, run in jobs]
+        for done, future in enumerate(futures, 1):
+            row = future.result()
+            rows.append(row)
+            print('[%d/%d] %s status=%s pdr=%s' % (done, len(jobs), row['dir'], row['status'], row.get('pdr')))
+
+    path = options.csv or os.path.join(options.output, 'results.csv')
+    os.makedirs(os.path.dirname(path) or '.', exist_ok=True)
+    with open(path, 'w', newline='') as out:
+        writer = csv.DictWriter(out, fieldnames=['dir', 'run'] + names + SUMMARY_FIELDS + ['status', 'seconds'])
+        writer.writeheader()
+        writer.writerows(rows)
+    print('results written to ' + path)
+
+    failed = [row for row in rows if row['status'] != 0]
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
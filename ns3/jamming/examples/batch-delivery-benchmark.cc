@@ -0,0 +1,224 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measures the scheduler work of NslWifiChannel deliveries with and without
+ * BatchDelivery. N ad hoc nodes on one channel sit on a square grid and
+ * broadcast frames in turn. The simulator runs on a heap scheduler that
+ * counts inserts and removals and records the largest number of pending
+ * events. That both modes see the same PHY receptions and drops is checked
+ * by the jamming-model test suite.
+ *
+ *   ./waf --run "batch-delivery-benchmark"
+ *   ./waf --run "batch-delivery-benchmark --nodes=100,400 --spacing=200"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/jamming-module.h"
+
+#include "benchmark-common.h"
+
+#include <algorithm>
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE ("BatchDeliveryBenchmark");
+
+using namespace ns3;
+
+/**
+ * Heap scheduler counting its operations.
+ */
+class CountingScheduler : public HeapScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+  CountingScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+  static uint64_t s_inserts;   // events inserted
+  static uint64_t s_removes;   // events removed, run or cancelled
+  static uint64_t s_maxSize;   // most events pending at once
+
+private:
+  uint64_t m_size;
+};
+
+uint64_t CountingScheduler::s_inserts = 0;
+uint64_t CountingScheduler::s_removes = 0;
+uint64_t CountingScheduler::s_maxSize = 0;
+
+NS_OBJECT_ENSURE_REGISTERED (CountingScheduler);
+
+TypeId
+CountingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CountingScheduler")
+    .SetParent<HeapScheduler> ()
+    .AddConstructor<CountingScheduler> ()
+  ;
+  return tid;
+}
+
+CountingScheduler::CountingScheduler ()
+  : m_size (0)
+{
+}
+
+void
+CountingScheduler::Insert (const Event &ev)
+{
+  s_inserts++;
+  s_maxSize = std::max (s_maxSize, ++m_size);
+  HeapScheduler::Insert (ev);
+}
+
+Scheduler::Event
+CountingScheduler::RemoveNext (void)
+{
+  s_removes++;
+  m_size--;
+  return HeapScheduler::RemoveNext ();
+}
+
+void
+CountingScheduler::Remove (const Event &ev)
+{
+  s_removes++;
+  m_size--;
+  HeapScheduler::Remove (ev);
+}
+
+static uint32_t g_rxBegin = 0;
+static uint32_t g_rxEnd = 0;
+static uint32_t g_rxDrop = 0;
+
+static void
+PhyRxBegin (Ptr<const Packet> packet)
+{
+  g_rxBegin++;
+}
+
+static void
+PhyRxEnd (Ptr<const Packet> packet)
+{
+  g_rxEnd++;
+}
+
+static void
+PhyRxDrop (Ptr<const Packet> packet, WifiPhyRxfailureReason reason)
+{
+  g_rxDrop++;
+}
+
+static void
+Broadcast (NetDeviceContainer devices, uint32_t index, uint32_t size, uint32_t count,
+           Time interval)
+{
+  Ptr<NetDevice> device = devices.Get (index);
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x0800);
+  if (count > 1)
+    {
+      Simulator::Schedule (interval, &Broadcast, devices, (index + 1) % devices.GetN (),
+                           size, count - 1, interval);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string nodeList = "10,50,200";
+  uint32_t frames = 200;
+  uint32_t size = 500;
+  double spacing = 50.0; // meters between nodes on a square grid
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "Comma separated numbers of nodes on the channel", nodeList);
+  cmd.AddValue ("frames", "Frames broadcast per node count, nodes take turns", frames);
+  cmd.AddValue ("size", "Payload size of the frames, in bytes", size);
+  cmd.AddValue ("spacing", "Distance between neighbouring nodes, in meters", spacing);
+  cmd.Parse (argc, argv);
+
+  std::string phyMode ("DsssRate1Mbps");
+  Config::SetDefault ("ns3::WifiRemoteStationManager::NonUnicastMode",
+                      StringValue (phyMode));
+
+  benchmark::WriteCsv (std::cout, "nodes", "batch", "rx_begin", "rx_end", "rx_drop", "inserts",
+                       "removes", "max_pending", "ms");
+
+  for (uint32_t n : benchmark::ParseList (nodeList))
+    {
+
+      for (uint32_t batch = 0; batch < 2; batch++)
+        {
+          ObjectFactory scheduler;
+          scheduler.SetTypeId ("ns3::CountingScheduler");
+          Simulator::SetScheduler (scheduler);
+
+          NodeContainer nodes;
+          nodes.Create (n);
+
+          WifiHelper wifi;
+          wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+          wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode",
+                                        StringValue (phyMode), "ControlMode",
+                                        StringValue (phyMode));
+          NslWifiPhyHelper wifiPhy = NslWifiPhyHelper::Default ();
+          NslWifiChannelHelper wifiChannel;
+          wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+          wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel");
+          Ptr<NslWifiChannel> channel = wifiChannel.Create ();
+          channel->SetAttribute ("BatchDelivery", BooleanValue (batch == 1));
+          wifiPhy.SetChannel (channel);
+          WifiMacHelper wifiMac;
+          wifiMac.SetType ("ns3::AdhocWifiMac");
+          NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+
+          benchmark::InstallGrid (nodes, spacing);
+
+          g_rxBegin = g_rxEnd = g_rxDrop = 0;
+          Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxBegin",
+                                         MakeCallback (&PhyRxBegin));
+          Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEnd",
+                                         MakeCallback (&PhyRxEnd));
+          Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxDrop",
+                                         MakeCallback (&PhyRxDrop));
+          Simulator::Schedule (Seconds (1.0), &Broadcast, devices, 0, size, frames,
+                               MilliSeconds (20));
+
+          CountingScheduler::s_inserts = 0;
+          CountingScheduler::s_removes = 0;
+          CountingScheduler::s_maxSize = 0;
+          benchmark::Clock::time_point start = benchmark::Clock::now ();
+          Simulator::Run ();
+          benchmark::Clock::time_point end = benchmark::Clock::now ();
+
+          benchmark::WriteCsv (std::cout, n, batch, g_rxBegin, g_rxEnd, g_rxDrop,
+                               CountingScheduler::s_inserts, CountingScheduler::s_removes,
+                               CountingScheduler::s_maxSize,
+                               benchmark::ElapsedNs (start, end) / 1e6);
+
+          Simulator::Destroy ();
+        }
+    }
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Skeleton shared by the jamming benchmarks: the comma separated size lists
+ * given on the command line, the square grid the nodes or PHYs sit on, the
+ * wall clock of the timed sections and the CSV lines printed to stdout.
+ */
+
+#ifndef BENCHMARK_COMMON_H
+#define BENCHMARK_COMMON_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace benchmark {
+
+/// Wall clock of the timed sections.
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * \param start start of a timed section
+ * \param end end of the timed section
+ * \return the wall clock time between them, in nanoseconds
+ */
+inline double
+ElapsedNs (Clock::time_point start, Clock::time_point end)
+{
+  return std::chrono::duration<double, std::nano> (end - start).count ();
+}
+
+/**
+ * \param list comma separated numbers, e.g. "100,1000,5000"
+ * \return the numbers, in the order of the list
+ */
+inline std::vector<uint32_t>
+ParseList (const std::string &list)
+{
+  std::vector<uint32_t> values;
+  std::stringstream stream (list);
+  std::string item;
+  while (std::getline (stream, item, ','))
+    {
+      values.push_back (std::stoul (item));
+    }
+  return values;
+}
+
+/**
+ * \param count number of nodes or PHYs on the grid
+ * \return the width of the square grid holding them
+ */
+inline uint32_t
+GridWidth (uint32_t count)
+{
+  return std::ceil (std::sqrt (count));
+}
+
+/**
+ * \param index index of the node or PHY
+ * \param count number of nodes or PHYs on the grid
+ * \param spacing distance between neighbours, in meters
+ * \return the position of the index on a square grid filled row by row
+ */
+inline Vector
+GridPosition (uint32_t index, uint32_t count, double spacing)
+{
+  uint32_t width = GridWidth (count);
+  return Vector (spacing * (index % width), spacing * (index / width), 0);
+}
+
+/**
+ * Places the nodes at fixed positions on a square grid, in the same layout
+ * as GridPosition.
+ *
+ * \param nodes the nodes
+ * \param spacing distance between neighbours, in meters
+ */
+inline void
+InstallGrid (NodeContainer nodes, double spacing)
+{
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (spacing),
+                                 "DeltaY", DoubleValue (spacing),
+                                 "GridWidth", UintegerValue (GridWidth (nodes.GetN ())));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+}
+
+/**
+ * Ends a CSV line.
+ *
+ * \param os the stream
+ */
+inline void
+WriteCsv (std::ostream &os)
+{
+  os << std::endl;
+}
+
+/**
+ * Writes one CSV line, the header with the column names or a row of values.
+ *
+ * \param os the stream
+ * \param first the first field
+ * \param rest the other fields
+ */
+template <typename T, typename... Rest>
+void
+WriteCsv (std::ostream &os, const T &first, const Rest &... rest)
+{
+  os << first;
+  if (sizeof... (rest) > 0)
+    {
+      os << ",";
+    }
+  WriteCsv (os, rest...);
+}
+
+} // namespace benchmark
+} // namespace ns3
+
+#endif /* BENCHMARK_COMMON_H */
@@ -0,0 +1,94 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Microbenchmark of the fan-out cost of NslWifiChannel. N PHYs are spread
+ * round robin over a number of channels on one NslWifiChannel, and every PHY
+ * in turn sends a jamming signal. Only the Send side is timed: the scheduled
+ * receptions are dropped when the simulator is destroyed. With the PHYs
+ * bucketed by channel number a send visits N / channels receivers, so the
+ * time per send should follow that column rather than N.
+ *
+ *   ./waf --run "channel-bucket-benchmark"
+ *   ./waf --run "channel-bucket-benchmark --phys=1000,5000 --channels=1"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/jamming-module.h"
+
+#include "benchmark-common.h"
+
+#include <iostream>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("ChannelBucketBenchmark");
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string phyList = "100,1000,5000";
+  uint32_t channels = 11;
+  uint32_t sends = 2000;
+  double spacing = 5.0; // meters between PHYs on a square grid
+
+  CommandLine cmd;
+  cmd.AddValue ("phys", "Comma separated numbers of PHYs on the channel", phyList);
+  cmd.AddValue ("channels", "Number of channel numbers the PHYs are spread over", channels);
+  cmd.AddValue ("sends", "Signals sent per PHY count", sends);
+  cmd.AddValue ("spacing", "Distance between neighbouring PHYs, in meters", spacing);
+  cmd.Parse (argc, argv);
+
+  benchmark::WriteCsv (std::cout, "phys", "channels", "sends", "receivers_per_send", "ns_per_send");
+
+  for (uint32_t n : benchmark::ParseList (phyList))
+    {
+
+      Ptr<NslWifiChannel> channel = CreateObject<NslWifiChannel> ();
+      channel->SetPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+      channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+      std::vector<Ptr<NslWifiPhy> > phys;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (benchmark::GridPosition (i, n, spacing));
+          Ptr<NslWifiPhy> phy = CreateObject<NslWifiPhy> ();
+          phy->SetMobility (mobility);
+          phy->SetChannelNumber (1 + i % channels);
+          phy->SetChannel (channel);
+          phys.push_back (phy);
+        }
+
+      benchmark::Clock::time_point start = benchmark::Clock::now ();
+      for (uint32_t i = 0; i < sends; i++)
+        {
+          channel->SendSignal (phys[i % n], 0.0, MicroSeconds (100));
+        }
+      benchmark::Clock::time_point end = benchmark::Clock::now ();
+
+      benchmark::WriteCsv (std::cout, n, channels, sends, (double) n / channels - 1,
+                           benchmark::ElapsedNs (start, end) / sends);
+
+      Simulator::Destroy ();
+    }
+
+  return 0;
+}
@@ -380,6 +380,7 @@ main (int argc, char *argv[])
                                                   MakeCallback (&TotalEnergy));
   // wireless module utility
   Ptr<WirelessModuleUtility> utilityPtr = utilities.Get (2);
+  utilityPtr->SetAttribute ("PeriodicRss", BooleanValue (true)); // Rss trace sampled while idle
   utilityPtr->TraceConnectWithoutContext ("Rss", MakeCallback (&NodeRss));
   utilityPtr->TraceConnectWithoutContext ("Pdr", MakeCallback (&NodePdr));
   /***************************************************************************/
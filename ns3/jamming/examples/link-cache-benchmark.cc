@@ -0,0 +1,116 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Times the link cache of NslWifiChannel. Two channels with the same PHY
+ * layout are built, one with LinkCache enabled and one without. Lookups are
+ * repeated for a number of rounds, so the cached channel computes each link
+ * once and the uncached one every round. That both return the same links is
+ * checked by the jamming-model test suite.
+ *
+ *   ./waf --run "link-cache-benchmark"
+ *   ./waf --run "link-cache-benchmark --phys=50,200 --loss=ns3::LogDistancePropagationLossModel"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/jamming-module.h"
+
+#include "benchmark-common.h"
+
+#include <iostream>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("LinkCacheBenchmark");
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string phyList = "20,100,300";
+  std::string lossModel = "ns3::FriisPropagationLossModel";
+  uint32_t rounds = 20;
+  double spacing = 5.0; // meters between PHYs on a square grid
+
+  CommandLine cmd;
+  cmd.AddValue ("phys", "Comma separated numbers of PHYs on the channel", phyList);
+  cmd.AddValue ("loss", "Propagation loss model", lossModel);
+  cmd.AddValue ("rounds", "Lookups of every link per PHY count", rounds);
+  cmd.AddValue ("spacing", "Distance between neighbouring PHYs, in meters", spacing);
+  cmd.Parse (argc, argv);
+
+  benchmark::WriteCsv (std::cout, "phys", "links", "rounds", "cached_ns_per_link",
+                       "uncached_ns_per_link");
+
+  for (uint32_t n : benchmark::ParseList (phyList))
+    {
+
+      Ptr<NslWifiChannel> channels[2];
+      std::vector<Ptr<NslWifiPhy> > phys[2];
+      for (uint32_t c = 0; c < 2; c++)
+        {
+          ObjectFactory loss;
+          loss.SetTypeId (lossModel);
+          channels[c] = CreateObject<NslWifiChannel> ();
+          channels[c]->SetAttribute ("LinkCache", BooleanValue (c == 0));
+          channels[c]->SetPropagationLossModel (loss.Create<PropagationLossModel> ());
+          channels[c]->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+          for (uint32_t i = 0; i < n; i++)
+            {
+              Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+              mobility->SetPosition (benchmark::GridPosition (i, n, spacing));
+              Ptr<NslWifiPhy> phy = CreateObject<NslWifiPhy> ();
+              phy->SetMobility (mobility);
+              phy->SetChannel (channels[c]);
+              phys[c].push_back (phy);
+            }
+        }
+
+      double elapsed[2];
+      for (uint32_t c = 0; c < 2; c++)
+        {
+          benchmark::Clock::time_point start = benchmark::Clock::now ();
+          for (uint32_t r = 0; r < rounds; r++)
+            {
+              for (uint32_t i = 0; i < n; i++)
+                {
+                  for (uint32_t j = 0; j < n; j++)
+                    {
+                      if (i == j)
+                        {
+                          continue;
+                        }
+                      Time delay;
+                      double rx;
+                      channels[c]->GetLink (phys[c][i], phys[c][j], 16.0 + r, delay, rx);
+                    }
+                }
+            }
+          elapsed[c] = benchmark::ElapsedNs (start, benchmark::Clock::now ());
+        }
+
+      uint64_t lookups = (uint64_t) rounds * n * (n - 1);
+      benchmark::WriteCsv (std::cout, n, n * (n - 1), rounds, elapsed[0] / lookups,
+                           elapsed[1] / lookups);
+
+      Simulator::Destroy ();
+    }
+
+  return 0;
+}
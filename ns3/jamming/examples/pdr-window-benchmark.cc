@@ -0,0 +1,120 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Microbenchmark of the per-packet cost of the sliding-window PDR in
+ * WirelessModuleUtility. Every window size is fed the same random sequence of
+ * received/corrupted packets through EndRxHandler, and the PDR after every
+ * packet is checked against the full window scan the utility used to do.
+ * The check runs on a second utility, outside the timed loops.
+ *
+ *   ./waf --run "pdr-window-benchmark"
+ *   ./waf --run "pdr-window-benchmark --windows=40,1600 --packets=1000000"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/jamming-module.h"
+
+#include "benchmark-common.h"
+
+#include <iostream>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("PdrWindowBenchmark");
+
+using namespace ns3;
+
+/**
+ * \brief Reference PDR: scan of the last window packets.
+ */
+static double
+ScanPdr (const std::vector<bool> &record, uint32_t received)
+{
+  uint32_t total = std::min<uint32_t> (received, record.size ());
+  uint32_t valid = 0;
+  for (uint32_t i = 0; i < total; i++)
+    {
+      if (record[i])
+        {
+          valid++;
+        }
+    }
+  return (double) valid / (double) total;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string windowList = "40,1600,16000,160000";
+  uint32_t packets = 200000;
+  double successRate = 0.8;
+
+  CommandLine cmd;
+  cmd.AddValue ("windows", "Comma separated PDR window sizes", windowList);
+  cmd.AddValue ("packets", "Packets received per window size", packets);
+  cmd.AddValue ("successRate", "Fraction of packets received successfully", successRate);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  std::vector<bool> status (packets);
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      status[i] = random->GetValue () < successRate;
+    }
+  Ptr<Packet> packet = Create<Packet> (100);
+
+  benchmark::WriteCsv (std::cout, "window", "packets", "pdr", "incremental_ns", "scan_ns");
+
+  for (uint32_t window : benchmark::ParseList (windowList))
+    {
+      Ptr<WirelessModuleUtility> utility = CreateObject<WirelessModuleUtility> ();
+      utility->SetPdrWindowSize (window);
+      benchmark::Clock::time_point start = benchmark::Clock::now ();
+      for (uint32_t i = 0; i < packets; i++)
+        {
+          utility->EndRxHandler (packet, 1e-9, status[i]);
+        }
+      benchmark::Clock::time_point incremental = benchmark::Clock::now ();
+
+      // what every packet used to cost: overwrite one slot, scan the window
+      std::vector<bool> record (window, false);
+      std::vector<double> scan (packets);
+      for (uint32_t i = 0; i < packets; i++)
+        {
+          record[i % window] = status[i];
+          scan[i] = ScanPdr (record, i + 1);
+        }
+      benchmark::Clock::time_point scanned = benchmark::Clock::now ();
+      double pdr = scan.back ();
+
+      Ptr<WirelessModuleUtility> check = CreateObject<WirelessModuleUtility> ();
+      check->SetPdrWindowSize (window);
+      for (uint32_t i = 0; i < packets; i++)
+        {
+          check->EndRxHandler (packet, 1e-9, status[i]);
+          NS_ABORT_MSG_UNLESS (scan[i] == check->GetPdr (), "incremental PDR " << check->GetPdr ()
+                               << " differs from the window scan " << scan[i] << " after packet " << i);
+        }
+
+      benchmark::WriteCsv (std::cout, window, packets, pdr,
+                           benchmark::ElapsedNs (start, incremental) / packets,
+                           benchmark::ElapsedNs (incremental, scanned) / packets);
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
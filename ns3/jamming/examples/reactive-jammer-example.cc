@@ -319,6 +319,8 @@ main (int argc, char *argv[])
   jammerHelper.Set ("ReactiveJammerReactToMitigation", UintegerValue(true));
   // install jammer
   JammerContainer jammers = jammerHelper.Install (c.Get (4));
+  // fixed stream, the jamming decisions repeat from run to run
+  jammerHelper.AssignStreams (jammers, 100);
   // Get pointer to Jammer
   Ptr<Jammer> jammerPtr = jammers.Get (0);
   // enable all jammer debug statements
@@ -361,6 +363,7 @@ main (int argc, char *argv[])
                                                   MakeCallback (&TotalEnergy));
   // wireless module utility
   Ptr<WirelessModuleUtility> utilityPtr = utilities.Get (2);
+  utilityPtr->SetAttribute ("PeriodicRss", BooleanValue (true)); // Rss trace sampled while idle
   utilityPtr->TraceConnectWithoutContext ("Rss", MakeCallback (&NodeRss));
   utilityPtr->TraceConnectWithoutContext ("Pdr", MakeCallback (&NodePdr));
   /***************************************************************************/
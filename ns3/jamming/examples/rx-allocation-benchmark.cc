@@ -0,0 +1,172 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Counts the heap allocations of the NslWifi receive path. N ad hoc nodes
+ * on one NslWifiChannel sit on a square grid, node 0 broadcasts a number of
+ * frames and every allocation made while the simulator runs is counted with
+ * a replaced global operator new. The allocations of one Packet::Copy of a
+ * frame are printed next to it. Every node count runs twice: with the packet
+ * shared by all receivers, a PHY copying it only once it synchronizes on it,
+ * and with NslWifiChannel::CopyPerReceiver, a copy for every receiver as the
+ * receive path used to make.
+ *
+ *   ./waf --run "rx-allocation-benchmark"
+ *   ./waf --run "rx-allocation-benchmark --nodes=10,50 --frames=200"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/jamming-module.h"
+
+#include "benchmark-common.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+NS_LOG_COMPONENT_DEFINE ("RxAllocationBenchmark");
+
+using namespace ns3;
+
+static uint64_t g_allocations = 0;
+
+void *
+operator new (std::size_t size)
+{
+  g_allocations++;
+  void *p = std::malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void
+operator delete (void *p) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete (void *p, std::size_t) noexcept
+{
+  std::free (p);
+}
+
+static uint32_t g_received = 0;
+
+static void
+PhyRxEnd (Ptr<const Packet> packet)
+{
+  g_received++;
+}
+
+static void
+Broadcast (Ptr<NetDevice> device, uint32_t size, uint32_t count, Time interval)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x0800);
+  if (count > 1)
+    {
+      Simulator::Schedule (interval, &Broadcast, device, size, count - 1, interval);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string nodeList = "10,50,200";
+  uint32_t frames = 100;
+  uint32_t size = 1000;
+  double spacing = 5.0; // meters between nodes on a square grid
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "Comma separated numbers of nodes on the channel", nodeList);
+  cmd.AddValue ("frames", "Frames broadcast by node 0 per node count", frames);
+  cmd.AddValue ("size", "Payload size of the frames, in bytes", size);
+  cmd.AddValue ("spacing", "Distance between neighbouring nodes, in meters", spacing);
+  cmd.Parse (argc, argv);
+
+  std::string phyMode ("DsssRate1Mbps");
+  Config::SetDefault ("ns3::WifiRemoteStationManager::NonUnicastMode",
+                      StringValue (phyMode));
+
+  benchmark::WriteCsv (std::cout, "nodes", "packets", "frames", "received", "allocs_per_frame",
+                       "allocs_per_rx", "allocs_per_copy");
+
+  for (uint32_t n : benchmark::ParseList (nodeList))
+    {
+
+      // shared packets, then a copy per receiver as the receive path used to make
+      for (bool copyPerReceiver : {false, true})
+        {
+          NodeContainer nodes;
+          nodes.Create (n);
+
+          WifiHelper wifi;
+          wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+          wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode",
+                                        StringValue (phyMode), "ControlMode",
+                                        StringValue (phyMode));
+          NslWifiPhyHelper wifiPhy = NslWifiPhyHelper::Default ();
+          NslWifiChannelHelper wifiChannel;
+          wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+          wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel");
+          Ptr<NslWifiChannel> channel = wifiChannel.Create ();
+          channel->SetAttribute ("CopyPerReceiver", BooleanValue (copyPerReceiver));
+          wifiPhy.SetChannel (channel);
+          WifiMacHelper wifiMac;
+          wifiMac.SetType ("ns3::AdhocWifiMac");
+          NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+
+          benchmark::InstallGrid (nodes, spacing);
+
+          WirelessModuleUtilityHelper utilityHelper;
+          utilityHelper.InstallAll ();
+
+          g_received = 0;
+          Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEnd",
+                                         MakeCallback (&PhyRxEnd));
+          Simulator::Schedule (Seconds (1.0), &Broadcast, devices.Get (0), size, frames,
+                               MilliSeconds (20));
+
+          // what each copy of a frame costs, as it looks on the air
+          Ptr<Packet> frame = Create<Packet> (size);
+          WifiMacHeader hdr;
+          hdr.SetType (WIFI_MAC_DATA);
+          frame->AddHeader (hdr);
+          uint64_t before = g_allocations;
+          Ptr<Packet> copy = frame->Copy ();
+          uint64_t copyAllocations = g_allocations - before;
+
+          before = g_allocations;
+          Simulator::Run ();
+          uint64_t allocations = g_allocations - before;
+
+          benchmark::WriteCsv (std::cout, n, copyPerReceiver ? "copy" : "shared", frames,
+                               g_received, (double) allocations / frames,
+                               g_received > 0 ? (double) allocations / g_received : 0.0,
+                               copyAllocations);
+
+          Simulator::Destroy ();
+        }
+    }
+
+  return 0;
+}
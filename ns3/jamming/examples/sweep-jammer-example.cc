@@ -0,0 +1,132 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * A sweep jammer next to a receiver on channel 1. Node 0 broadcasts frames
+ * at a fixed interval, node 2 sweeps the channels of its schedule and the
+ * fraction of frames node 1 receives is printed. Only the hops on channel 1
+ * cost frames, so the loss follows the share of the period spent there.
+ *
+ *   ./waf --run "sweep-jammer-example"
+ *   ./waf --run "sweep-jammer-example --schedule='1:30ms 6:10ms 11:10ms'"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/energy-module.h"
+#include "ns3/jamming-module.h"
+
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE ("SweepJammerExample");
+
+using namespace ns3;
+
+static uint32_t g_received = 0;
+
+static void
+PhyRxEnd (Ptr<const Packet> packet)
+{
+  g_received++;
+}
+
+static void
+Broadcast (Ptr<NetDevice> device, uint32_t size, uint32_t count, Time interval)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x0800);
+  if (count > 1)
+    {
+      Simulator::Schedule (interval, &Broadcast, device, size, count - 1, interval);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string schedule = "1:10ms 6:10ms 11:10ms";
+  uint32_t frames = 500;
+  uint32_t size = 200;
+  bool jam = true;
+
+  CommandLine cmd;
+  cmd.AddValue ("schedule", "Hop schedule of the sweep jammer", schedule);
+  cmd.AddValue ("frames", "Frames broadcast by node 0", frames);
+  cmd.AddValue ("size", "Payload size of the frames, in bytes", size);
+  cmd.AddValue ("jam", "Start the sweep jammer", jam);
+  cmd.Parse (argc, argv);
+
+  std::string phyMode ("DsssRate1Mbps");
+  Config::SetDefault ("ns3::WifiRemoteStationManager::NonUnicastMode",
+                      StringValue (phyMode));
+
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode",
+                                StringValue (phyMode), "ControlMode",
+                                StringValue (phyMode));
+  NslWifiPhyHelper wifiPhy = NslWifiPhyHelper::Default ();
+  wifiPhy.Set ("TxPowerStart", DoubleValue (0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (20));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (2));
+  NslWifiChannelHelper wifiChannel = NslWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+
+  // sender, receiver and jammer next to the receiver
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 0.0));
+  positions->Add (Vector (10.0, 0.0, 0.0));
+  positions->Add (Vector (12.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Install (nodes);
+  WirelessModuleUtilityHelper utilityHelper;
+  utilityHelper.Install (nodes);
+
+  JammerHelper jammerHelper;
+  jammerHelper.SetJammerType ("ns3::SweepJammer");
+  jammerHelper.Set ("SweepJammerSchedule", StringValue (schedule));
+  JammerContainer jammers = jammerHelper.Install (nodes.Get (2));
+  if (jam)
+    {
+      Simulator::Schedule (Seconds (1.0), &Jammer::StartJammer, jammers.Get (0));
+    }
+
+  Ptr<WifiPhy> receiver = DynamicCast<WifiNetDevice> (devices.Get (1))->GetPhy ();
+  receiver->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&PhyRxEnd));
+  Time interval = MilliSeconds (7);
+  Simulator::Schedule (Seconds (1.0), &Broadcast, devices.Get (0), size, frames, interval);
+  Simulator::Stop (Seconds (1.0) + interval * frames + Seconds (1.0));
+  Simulator::Run ();
+
+  std::cout << "schedule \"" << schedule << "\", jammer " << (jam ? "on" : "off")
+            << ": " << g_received << " of " << frames << " frames received ("
+            << 100.0 * g_received / frames << "%)" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -19,6 +19,7 @@
  */
 
 #include "jammer-helper.h"
+#include "ns3/reactive-jammer.h"
 #include "ns3/energy-source-container.h"
 #include "ns3/log.h"
 #include "ns3/config.h"
@@ -86,6 +87,21 @@ JammerHelper::Install (std::string nodeName) const
   return Install (node);
 }
 
+int64_t
+JammerHelper::AssignStreams (JammerContainer c, int64_t stream)
+{
+  int64_t currentStream = stream;
+  for (JammerContainer::Iterator i = c.Begin (); i != c.End (); i++)
+    {
+      Ptr<ReactiveJammer> reactive = DynamicCast<ReactiveJammer> (*i);
+      if (reactive != 0)
+        {
+          currentStream += reactive->AssignStreams (currentStream);
+        }
+    }
+  return (currentStream - stream);
+}
+
 void
 JammerHelper::EnableLogComponents (void)
 {
@@ -88,6 +88,16 @@ public:
    */
   JammerContainer Install (std::string nodeName) const;
 
+  /**
+   * \param c The jammers whose random variables get fixed streams.
+   * \param stream First stream index to use.
+   * \returns Number of stream indices assigned.
+   *
+   * Assigns fixed random variable streams to the jammers that draw random
+   * decisions, so a run reproduces its jamming decisions.
+   */
+  int64_t AssignStreams (JammerContainer c, int64_t stream);
+
   /**
    * Helper to enable all Jammer log components with one statement.
    */
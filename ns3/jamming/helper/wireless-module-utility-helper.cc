@@ -24,16 +24,19 @@
 #include "ns3/simulator.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
+#include "ns3/net-device.h"
 
 NS_LOG_COMPONENT_DEFINE ("WirelessModuleUtilityHelper");
 
 namespace ns3 {
 
 WirelessModuleUtilityHelper::WirelessModuleUtilityHelper ()
+  : m_filterDeviceType (false)
 {
   m_headerInclusionList.clear ();
   m_headerExclusionList.clear ();
   m_rssMeasurementCallback.Nullify ();
+  m_filter.Nullify ();
   m_wirelessUtility.SetTypeId ("ns3::WirelessModuleUtility");
 }
 
@@ -91,6 +94,144 @@ WirelessModuleUtilityHelper::SetRssMeasurementCallback (Callback<double> RssCall
   m_rssMeasurementCallback = RssCallback;
 }
 
+void
+WirelessModuleUtilityHelper::SetDeviceTypeFilter (std::string typeName)
+{
+  NS_LOG_FUNCTION (this << typeName);
+  m_filterDeviceType = !typeName.empty ();
+  if (m_filterDeviceType)
+    {
+      m_deviceType = TypeId::LookupByName (typeName);
+    }
+}
+
+void
+WirelessModuleUtilityHelper::AddNamePattern (std::string pattern)
+{
+  NS_LOG_FUNCTION (this << pattern);
+  m_namePatterns.push_back (pattern);
+}
+
+void
+WirelessModuleUtilityHelper::SetFilter (Callback<bool, Ptr<Node> > filter)
+{
+  NS_LOG_FUNCTION (this);
+  m_filter = filter;
+}
+
+bool
+WirelessModuleUtilityHelper::IsSelected (Ptr<Node> node) const
+{
+  NS_LOG_FUNCTION (this << node);
+
+  if (m_filterDeviceType)
+    {
+      bool found = false;
+      for (uint32_t i = 0; i < node->GetNDevices () && !found; i++)
+        {
+          TypeId tid = node->GetDevice (i)->GetInstanceTypeId ();
+          found = tid == m_deviceType || tid.IsChildOf (m_deviceType);
+        }
+      if (!found)
+        {
+          return false;
+        }
+    }
+
+  if (!m_namePatterns.empty ())
+    {
+      std::string name = Names::FindName (node);
+      bool matched = false;
+      std::vector<std::string>::const_iterator i;
+      for (i = m_namePatterns.begin (); i != m_namePatterns.end () && !matched; i++)
+        {
+          matched = MatchName (*i, name);
+        }
+      if (!matched)
+        {
+          return false;
+        }
+    }
+
+  return m_filter.IsNull () || m_filter (node);
+}
+
+bool
+WirelessModuleUtilityHelper::MatchName (const std::string &pattern, const std::string &name)
+{
+  // iterative glob match, backtracking to the last '*' on a mismatch
+  std::size_t p = 0, n = 0;
+  std::size_t star = std::string::npos, resume = 0;
+  while (n < name.size ())
+    {
+      if (p < pattern.size () && (pattern[p] == '?' || pattern[p] == name[n]))
+        {
+          p++;
+          n++;
+        }
+      else if (p < pattern.size () && pattern[p] == '*')
+        {
+          star = p++;
+          resume = n;
+        }
+      else if (star != std::string::npos)
+        {
+          p = star + 1;
+          n = ++resume;
+        }
+      else
+        {
+          return false;
+        }
+    }
+  while (p < pattern.size () && pattern[p] == '*')
+    {
+      p++;
+    }
+  return p == pattern.size ();
+}
+
+static std::string
+RegisteredName (Ptr<Node> node)
+{
+  return Names::FindName (node);
+}
+
+void
+WirelessModuleUtilityHelper::PrintFootprint (std::ostream &os, NodeContainer c)
+{
+  PrintFootprint (os, c, MakeCallback (&RegisteredName));
+}
+
+void
+WirelessModuleUtilityHelper::PrintFootprint (std::ostream &os, NodeContainer c,
+                                             Callback<std::string, Ptr<Node> > nameOf)
+{
+  uint32_t installed = 0;
+  uint64_t totalBytes = 0;
+  os << "node,name,devices,utility,bytes" << std::endl;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      std::string devices;
+      for (uint32_t d = 0; d < node->GetNDevices (); d++)
+        {
+          devices += (d > 0 ? " " : "") + node->GetDevice (d)->GetInstanceTypeId ().GetName ();
+        }
+      Ptr<WirelessModuleUtility> util = node->GetObject<WirelessModuleUtility> ();
+      uint64_t bytes = util == NULL ? 0 : util->GetFootprint ();
+      os << node->GetId () << ","
+         << nameOf (node) << ","
+         << devices << ","
+         << (util == NULL ? 0 : 1) << ","
+         << bytes << std::endl;
+      installed += util == NULL ? 0 : 1;
+      totalBytes += bytes;
+    }
+  NS_LOG_INFO ("WirelessModuleUtilityHelper:" << installed << " of " << c.GetN () <<
+               " nodes have a utility, " << totalBytes << " bytes");
+}
+
 WirelessModuleUtilityContainer
 WirelessModuleUtilityHelper::Install (Ptr<Node> node) const
 {
@@ -105,6 +246,12 @@ WirelessModuleUtilityHelper::Install (NodeContainer c) const
   WirelessModuleUtilityContainer container;
   for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
     {
+      if (!IsSelected (*i))
+        {
+          NS_LOG_DEBUG ("WirelessModuleUtilityHelper:Node #" << (*i)->GetId () <<
+                        " filtered out, no utility installed");
+          continue;
+        }
       Ptr<WirelessModuleUtility> utility = DoInstall (*i);
       container.Add (utility);
     }
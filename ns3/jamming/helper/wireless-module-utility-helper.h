@@ -27,12 +27,17 @@
 #include "ns3/node-container.h"
 #include "ns3/wireless-module-utility.h"
 #include "wireless-module-utility-container.h"
+#include <ostream>
 #include <string>
 
 namespace ns3 {
 
 /**
  * \brief Create wireless utility objects \ref ns3::WirelessModuleUtility.
+ *
+ * Install methods only create utilities on nodes that pass the installation
+ * filters (device type, name pattern and custom filter). Without filters
+ * every given node gets one.
  */
 class WirelessModuleUtilityHelper
 {
@@ -81,6 +86,56 @@ public:
    */
   void SetRssMeasurementCallback (Callback<double> RssCallback);
 
+  /**
+   * \brief Only install on nodes with a device of the given type.
+   *
+   * \param typeName TypeId name of the device, subclasses match too, e.g.
+   * "ns3::WifiNetDevice". Empty to disable the filter.
+   */
+  void SetDeviceTypeFilter (std::string typeName);
+
+  /**
+   * \brief Only install on nodes whose name (see \ref ns3::Names) matches one
+   * of the added patterns.
+   *
+   * \param pattern Node name pattern, '*' matches any run of characters and
+   * '?' any single character.
+   */
+  void AddNamePattern (std::string pattern);
+
+  /**
+   * \brief Only install on nodes for which the callback returns true.
+   *
+   * \param filter Custom installation filter, null to disable it.
+   */
+  void SetFilter (Callback<bool, Ptr<Node> > filter);
+
+  /**
+   * \param node Node to check.
+   * \returns True if the node passes all installation filters.
+   */
+  bool IsSelected (Ptr<Node> node) const;
+
+  /**
+   * \param pattern Pattern with '*' and '?' wildcards.
+   * \param name Name to match.
+   * \returns True if the whole name matches the pattern.
+   */
+  static bool MatchName (const std::string &pattern, const std::string &name);
+
+  /**
+   * \brief Writes one CSV line per node: id, name, device types, whether a
+   * utility is installed and the approximate bytes it holds.
+   *
+   * \param os Output stream.
+   * \param c Nodes to report on.
+   * \param nameOf Returns the name to print for a node, by default the one
+   * registered with \ref ns3::Names.
+   */
+  static void PrintFootprint (std::ostream &os, NodeContainer c);
+  static void PrintFootprint (std::ostream &os, NodeContainer c,
+                              Callback<std::string, Ptr<Node> > nameOf);
+
   /**
    * \param node The node on which a utility object must be created.
    * \returns Container contains all the JammingMitigation object created by
@@ -103,7 +158,7 @@ public:
   WirelessModuleUtilityContainer Install (std::string nodeName) const;
 
   /**
-   * Install on *ALL* nodes exists in simulation.
+   * Install on *ALL* nodes exists in simulation that pass the filters.
    * \returns Container contains all the JammingMitigation object created by
    * this method.
    */
@@ -127,6 +182,12 @@ private:
   std::vector<std::string> m_headerInclusionList; // header/trailer inclusion list
   std::vector<std::string> m_headerExclusionList; // header/trailer exclusion list
 
+  // installation filters
+  TypeId m_deviceType;          // required device type
+  bool m_filterDeviceType;      // device type filter enabled
+  std::vector<std::string> m_namePatterns;  // node name patterns
+  Callback<bool, Ptr<Node> > m_filter;      // custom filter
+
 };
 
 } // namespace ns3
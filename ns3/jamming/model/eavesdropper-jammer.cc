@@ -58,6 +58,44 @@ EavesdropperJammer::GetTypeId (void)
                    MakeUintegerAccessor (&EavesdropperJammer::SetScanCycles,
                                          &EavesdropperJammer::GetScanCycles),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("EavesdropperJammerFollowMode",
+                   "What to do once scanning completes: 0 keep listening, 1 jam "
+                   "packets on the busiest channel, 2 jam it continuously.",
+                   UintegerValue (0), // default to never jam
+                   MakeUintegerAccessor (&EavesdropperJammer::SetFollowMode,
+                                         &EavesdropperJammer::GetFollowMode),
+                   MakeUintegerChecker<uint32_t> (0, FOLLOW_CONSTANT))
+    .AddAttribute ("EavesdropperJammerTxPower",
+                   "Power to send jamming signal in follow mode, in Watts.",
+                   DoubleValue (0.001), // 0dBm
+                   MakeDoubleAccessor (&EavesdropperJammer::SetTxPower,
+                                       &EavesdropperJammer::GetTxPower),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("EavesdropperJammerJammingDuration",
+                   "Jamming burst duration in follow mode.",
+                   TimeValue (MilliSeconds (5.0)),
+                   MakeTimeAccessor (&EavesdropperJammer::SetJammingDuration,
+                                     &EavesdropperJammer::GetJammingDuration),
+                   MakeTimeChecker ())
+    .AddAttribute ("EavesdropperJammerRxTxSwitchingDelay",
+                   "Rx to tx switching delay in reactive follow mode.",
+                   TimeValue (MicroSeconds (0.1)),
+                   MakeTimeAccessor (&EavesdropperJammer::SetRxTxSwitchingDelay,
+                                     &EavesdropperJammer::GetRxTxSwitchingDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("EavesdropperJammerRescanInterval",
+                   "Time spent jamming the busiest channel before scanning again, "
+                   "0 to never rescan.",
+                   TimeValue (Seconds (10.0)),
+                   MakeTimeAccessor (&EavesdropperJammer::SetRescanInterval,
+                                     &EavesdropperJammer::GetRescanInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("EavesdropperJammerTrafficDecay",
+                   "Weight kept from the previous traffic histogram at each rescan.",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&EavesdropperJammer::SetTrafficDecay,
+                                       &EavesdropperJammer::GetTrafficDecay),
+                   MakeDoubleChecker<double> (0.0, 1.0))
     ;
   return tid;
 }
@@ -65,7 +103,10 @@ EavesdropperJammer::GetTypeId (void)
 EavesdropperJammer::EavesdropperJammer ()
   :  m_scanCount (0),
      m_scanComplete (false),
-     m_isScan (false)
+     m_isScan (false),
+     m_followMode (FOLLOW_NONE),
+     m_following (false),
+     m_targetChannel (0)
 {
   m_numOfPktsReceived.clear (); // clear packet count list
 }
@@ -132,6 +173,125 @@ EavesdropperJammer::GetScanCycles (void) const
   return m_totalScanCycles;
 }
 
+void
+EavesdropperJammer::SetFollowMode (uint32_t mode)
+{
+  NS_LOG_FUNCTION (this << mode);
+  m_followMode = static_cast<FollowMode> (mode);
+}
+
+uint32_t
+EavesdropperJammer::GetFollowMode (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_followMode;
+}
+
+void
+EavesdropperJammer::SetTxPower (double power)
+{
+  NS_LOG_FUNCTION (this << power);
+  m_txPower = power;
+}
+
+double
+EavesdropperJammer::GetTxPower (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_txPower;
+}
+
+void
+EavesdropperJammer::SetJammingDuration (Time duration)
+{
+  NS_LOG_FUNCTION (this << duration);
+  m_jammingDuration = duration;
+}
+
+Time
+EavesdropperJammer::GetJammingDuration (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_jammingDuration;
+}
+
+void
+EavesdropperJammer::SetRxTxSwitchingDelay (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  m_rxTxSwitchingDelay = interval;
+}
+
+Time
+EavesdropperJammer::GetRxTxSwitchingDelay (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rxTxSwitchingDelay;
+}
+
+void
+EavesdropperJammer::SetRescanInterval (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  m_rescanInterval = interval;
+}
+
+Time
+EavesdropperJammer::GetRescanInterval (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rescanInterval;
+}
+
+void
+EavesdropperJammer::SetTrafficDecay (double decay)
+{
+  NS_LOG_FUNCTION (this << decay);
+  m_trafficDecay = decay;
+}
+
+double
+EavesdropperJammer::GetTrafficDecay (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_trafficDecay;
+}
+
+double
+EavesdropperJammer::GetChannelTraffic (uint16_t channel) const
+{
+  NS_LOG_FUNCTION (this << channel);
+  if (channel >= m_numOfPktsReceived.size ())
+    {
+      return 0.0;
+    }
+  return m_numOfPktsReceived[channel];
+}
+
+uint16_t
+EavesdropperJammer::GetBusiestChannel (void) const
+{
+  NS_LOG_FUNCTION (this);
+  uint16_t busiest = 0;
+  double most = 0.0;
+  for (uint16_t channel = 1; channel < m_numOfPktsReceived.size (); channel++)
+    {
+      if (m_numOfPktsReceived[channel] > most)
+        {
+          most = m_numOfPktsReceived[channel];
+          busiest = channel;
+        }
+    }
+  return busiest;
+}
+
+uint16_t
+EavesdropperJammer::GetTargetChannel (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_following ? m_targetChannel : 0;
+}
+
 void
 EavesdropperJammer::ClearPacketCountList (void)
 {
@@ -147,6 +307,9 @@ void
 EavesdropperJammer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_rxTimeoutEvent.Cancel ();
+  m_jammingEvent.Cancel ();
+  m_rescanEvent.Cancel ();
 }
 
 void
@@ -154,6 +317,8 @@ EavesdropperJammer::DoStopJammer (void)
 {
   NS_LOG_FUNCTION (this);
   m_rxTimeoutEvent.Cancel ();
+  m_jammingEvent.Cancel ();
+  m_rescanEvent.Cancel ();
 }
 
 void
@@ -163,7 +328,11 @@ EavesdropperJammer::DoJamming (void)
   NS_LOG_DEBUG ("EavesdropperJammer:At Node #" << GetId () <<
                 ", Scheduling initial RX timeout at DoJamming");
 
-  if (m_isScan) // check if in scan mode
+  if (m_isScan && m_following) // resume jamming after a restart
+    {
+      FollowBusiestChannel ();
+    }
+  else if (m_isScan) // check if in scan mode
     {
       m_rxTimeoutEvent.Cancel (); // cancel previous RX timeout
       // schedule RX timeout
@@ -177,7 +346,17 @@ bool
 EavesdropperJammer::DoStartRxHandler (Ptr<Packet> packet, double startRss)
 {
   NS_LOG_FUNCTION (this << packet << startRss);
-  return true;
+
+  if (m_following && m_followMode == FOLLOW_REACTIVE)
+    {
+      NS_LOG_DEBUG ("EavesdropperJammer:At Node #" << GetId () <<
+                    ", Jamming packet on channel " << m_targetChannel);
+      m_jammingEvent.Cancel (); // cancel previously scheduled event
+      m_jammingEvent = Simulator::Schedule (m_rxTxSwitchingDelay,
+                                            &EavesdropperJammer::SendBurst,
+                                            this);
+    }
+  return !m_following;
 }
 
 bool
@@ -194,11 +373,11 @@ EavesdropperJammer::DoEndRxHandler (Ptr<Packet> packet, double averageRss)
 
   if (m_isScan)
     {
-      // initialize packet count list ONLY if it's empty.
+      // initialize packet count list ONLY if it's empty, indexed by channel
       if (m_numOfPktsReceived.empty ())
         {
-          m_numOfPktsReceived.assign (m_utility->GetPhyLayerInfo ().numOfChannels,
-                                      false);
+          m_numOfPktsReceived.assign (m_utility->GetPhyLayerInfo ().numOfChannels + 1,
+                                      0.0);
         }
       if (!m_scanComplete)
         {
@@ -220,9 +399,17 @@ void
 EavesdropperJammer::DoEndTxHandler (Ptr<Packet> packet, double txPower)
 {
   NS_LOG_FUNCTION (this << packet << txPower);
-  // we should never reach this function, because eavesdropper never transmits.
-  NS_FATAL_ERROR ("EavesdropperJammer:At Node #" << GetId () <<
-                  ", DoEndTxHandler Called!");
+  // we should never reach this function unless jamming in follow mode.
+  if (m_followMode == FOLLOW_NONE)
+    {
+      NS_FATAL_ERROR ("EavesdropperJammer:At Node #" << GetId () <<
+                      ", DoEndTxHandler Called!");
+    }
+  if (m_following && m_followMode == FOLLOW_CONSTANT)
+    {
+      m_jammingEvent = Simulator::ScheduleNow (&EavesdropperJammer::SendBurst,
+                                               this);
+    }
 }
 
 void
@@ -269,6 +456,11 @@ EavesdropperJammer::RxTimeoutHandler (void)
       m_scanComplete = true;
       NS_LOG_DEBUG ("EavesdropperJammer:At Node #" << GetId () <<
                     ", Scan completed!");
+      if (m_followMode != FOLLOW_NONE && IsJammerOn ())
+        {
+          FollowBusiestChannel ();
+          return;
+        }
     }
 
   // schedule next RX timeout
@@ -277,4 +469,103 @@ EavesdropperJammer::RxTimeoutHandler (void)
                                           this);
 }
 
+void
+EavesdropperJammer::FollowBusiestChannel (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_utility != NULL);
+
+  m_targetChannel = GetBusiestChannel ();
+  if (m_targetChannel == 0)
+    {
+      NS_LOG_DEBUG ("EavesdropperJammer:At Node #" << GetId () <<
+                    ", No traffic heard, scanning again!");
+      m_following = false;
+      m_scanCount = 0;
+      m_scanComplete = false;
+      m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
+                                              &EavesdropperJammer::RxTimeoutHandler,
+                                              this);
+      return;
+    }
+
+  NS_LOG_DEBUG ("EavesdropperJammer:At Node #" << GetId () <<
+                ", Following busiest channel " << m_targetChannel << " with " <<
+                m_numOfPktsReceived[m_targetChannel] << " packets, At " <<
+                Simulator::Now ().GetSeconds () << "s");
+  m_following = true;
+
+  Time delay = Seconds (0.0);
+  if (m_utility->GetPhyLayerInfo ().currentChannel != m_targetChannel)
+    {
+      m_utility->SwitchChannel (m_targetChannel);
+      delay = m_utility->GetPhyLayerInfo ().channelSwitchDelay;
+    }
+
+  m_jammingEvent.Cancel ();
+  if (m_followMode == FOLLOW_CONSTANT)
+    {
+      m_jammingEvent = Simulator::Schedule (delay,
+                                            &EavesdropperJammer::SendBurst,
+                                            this);
+    }
+
+  m_rescanEvent.Cancel ();
+  if (m_rescanInterval.IsStrictlyPositive ())
+    {
+      m_rescanEvent = Simulator::Schedule (m_rescanInterval,
+                                           &EavesdropperJammer::Rescan,
+                                           this);
+    }
+}
+
+void
+EavesdropperJammer::Rescan (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_DEBUG ("EavesdropperJammer:At Node #" << GetId () <<
+                ", Rescanning, At " << Simulator::Now ().GetSeconds () << "s");
+
+  m_following = false;
+  m_jammingEvent.Cancel ();
+
+  // older scans still count, at a decayed weight
+  for (uint32_t i = 0; i < m_numOfPktsReceived.size (); i++)
+    {
+      m_numOfPktsReceived[i] *= m_trafficDecay;
+    }
+
+  m_scanCount = 0;
+  m_scanComplete = false;
+  m_rxTimeoutEvent.Cancel ();
+  m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
+                                          &EavesdropperJammer::RxTimeoutHandler,
+                                          this);
+}
+
+void
+EavesdropperJammer::SendBurst (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsJammerOn () || !m_following)
+    {
+      return;
+    }
+
+  NS_LOG_DEBUG ("EavesdropperJammer:At Node #" << GetId () <<
+                ", Sending jamming signal with power = " << m_txPower <<
+                " W on channel " << m_targetChannel);
+  double actualPower = m_utility->SendJammingSignal (m_txPower, m_jammingDuration);
+  if (actualPower != 0.0)
+    {
+      NS_LOG_DEBUG ("EavesdropperJammer:At Node #" << GetId () <<
+                    ", Jamming signal sent with power = " << actualPower << " W");
+    }
+  else
+    {
+      NS_LOG_ERROR ("EavesdropperJammer:At Node #" << GetId () <<
+                    ", Failed to send jamming signal!");
+    }
+}
+
 } // namespace ns3
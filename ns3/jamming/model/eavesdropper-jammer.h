@@ -29,10 +29,25 @@ namespace ns3 {
 
 /**
  * Eavesdropper Jammer.
+ *
+ * In scan mode the jammer hops through all channels and keeps a histogram of
+ * the packets heard on each. With a follow mode set, the jammer moves to the
+ * busiest channel once the scan cycles complete and jams it, reactively or
+ * constantly. Every rescan interval it decays the histogram and scans again,
+ * so the target follows the traffic.
  */
 class EavesdropperJammer : public Jammer
 {
 public:
+  /**
+   * What the jammer does once scanning completes.
+   */
+  enum FollowMode {
+    FOLLOW_NONE = 0,  // Keep listening, never jam
+    FOLLOW_REACTIVE,  // Jam every packet heard on the busiest channel
+    FOLLOW_CONSTANT   // Jam the busiest channel continuously
+  };
+
   static TypeId GetTypeId (void);
   EavesdropperJammer ();
   virtual ~EavesdropperJammer ();
@@ -60,6 +75,34 @@ public:
   bool GetScanMode (void) const;
   void SetScanCycles (uint32_t cycles);
   uint32_t GetScanCycles (void) const;
+  void SetFollowMode (uint32_t mode);
+  uint32_t GetFollowMode (void) const;
+  void SetTxPower (double power);
+  double GetTxPower (void) const;
+  void SetJammingDuration (Time duration);
+  Time GetJammingDuration (void) const;
+  void SetRxTxSwitchingDelay (Time interval);
+  Time GetRxTxSwitchingDelay (void) const;
+  void SetRescanInterval (Time interval);
+  Time GetRescanInterval (void) const;
+  void SetTrafficDecay (double decay);
+  double GetTrafficDecay (void) const;
+
+  /**
+   * \param channel Channel number.
+   * \returns Decayed number of packets heard on the channel.
+   */
+  double GetChannelTraffic (uint16_t channel) const;
+
+  /**
+   * \returns Channel with the most traffic heard, 0 if nothing was heard.
+   */
+  uint16_t GetBusiestChannel (void) const;
+
+  /**
+   * \returns Channel being jammed in follow mode, 0 while scanning.
+   */
+  uint16_t GetTargetChannel (void) const;
 
   /**
    * Resets the packet count list for Eavesdropper scan mode.
@@ -84,7 +127,9 @@ private:
    *
    * \param packet Pointer to incoming packet.
    * \param startRss Start RSS of packet.
-   * \returns True. Eavesdropper jammer will *always* accept incoming packets.
+   * \returns True, except while jamming in follow mode.
+   *
+   * In reactive follow mode, schedules a jamming burst for the packet.
    */
   virtual bool DoStartRxHandler (Ptr<Packet> packet, double startRss);
   
@@ -102,6 +147,8 @@ private:
    * \brief Notifies jammer of end of sending jamming signal
    *
    * \param packet Pointer to dummy packet that was sent
+   *
+   * In constant follow mode, sends the next burst.
    */
   virtual void DoEndTxHandler (Ptr<Packet> packet, double txPower);
 
@@ -112,6 +159,22 @@ private:
    */
   void RxTimeoutHandler (void);
 
+  /**
+   * Switches to the busiest channel and starts jamming it, or scans again if
+   * nothing was heard.
+   */
+  void FollowBusiestChannel (void);
+
+  /**
+   * Stops jamming, decays the traffic histogram and starts a new scan.
+   */
+  void Rescan (void);
+
+  /**
+   * Sends a jamming burst on the target channel.
+   */
+  void SendBurst (void);
+
 private:
   Ptr<WirelessModuleUtility> m_utility;
   Ptr<EnergySource> m_source;
@@ -122,13 +185,24 @@ private:
   uint32_t m_scanCount;       // # of channels scanned
   bool m_scanComplete;        // flag set to indicate scanning is complete
   bool m_isScan;              // set to run in scan mode
+  FollowMode m_followMode;    // what to do once scanning completes
+  bool m_following;           // true while jamming the target channel
+  uint16_t m_targetChannel;   // channel jammed in follow mode
+  double m_txPower;           // TX power in follow mode
+  Time m_jammingDuration;     // burst duration in follow mode
+  Time m_rxTxSwitchingDelay;  // delay to switch from Rx to Tx
+  Time m_rescanInterval;      // time spent jamming before rescanning
+  double m_trafficDecay;      // histogram weight kept across rescans
+  EventId m_jammingEvent;     // next jamming burst
+  EventId m_rescanEvent;      // next rescan
   /**
    * This list keeps a record of number of packets received in each channel.
    * Total number of channels depends on the PHY layer. The list is updated by
    * the eavesdropper jammer in scanning mode. It is used to determine which
-   * channel has the most traffic.
+   * channel has the most traffic. Indexed by channel number, entry 0 unused.
+   * Counts are scaled by the traffic decay at each rescan.
    */
-  std::vector<int> m_numOfPktsReceived;
+  std::vector<double> m_numOfPktsReceived;
 
 };
 
@@ -0,0 +1,429 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jamming-coordinator.h"
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/energy-source-container.h"
+#include <algorithm>
+#include <math.h>
+
+NS_LOG_COMPONENT_DEFINE ("JammingCoordinator");
+
+/*
+ * Jamming Coordinator
+ */
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (JammingCoordinator);
+
+TypeId
+JammingCoordinator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::JammingCoordinator")
+    .SetParent<Object> ()
+    .AddConstructor<JammingCoordinator> ()
+    .AddAttribute ("EnergyBudget",
+                   "Energy the coordinated jammers may use while active, in Joules.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&JammingCoordinator::SetEnergyBudget,
+                                       &JammingCoordinator::GetEnergyBudget),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Interval",
+                   "Interval between allocation decisions.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&JammingCoordinator::SetInterval,
+                                     &JammingCoordinator::GetInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Horizon",
+                   "Time to spread the budget over, 0 to spend it as soon as useful.",
+                   TimeValue (Seconds (0.0)),
+                   MakeTimeAccessor (&JammingCoordinator::SetHorizon,
+                                     &JammingCoordinator::GetHorizon),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxActive",
+                   "Maximum number of jammers on at once, 0 for no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JammingCoordinator::SetMaxActive,
+                                         &JammingCoordinator::GetMaxActive),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Alpha",
+                   "Weight of the latest interval in the per-jammer estimates.",
+                   DoubleValue (0.3),
+                   MakeDoubleAccessor (&JammingCoordinator::SetAlpha,
+                                       &JammingCoordinator::GetAlpha),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddTraceSource ("Allocation",
+                     "Jammers switched on, energy spent and target PDR degradation, "
+                     "at each decision.",
+                     MakeTraceSourceAccessor (&JammingCoordinator::m_allocationTrace),
+                     "ns3::JammingCoordinator::AllocationTracedCallback")
+  ;
+  return tid;
+}
+
+JammingCoordinator::JammingCoordinator ()
+  :  m_energySpent (0.0),
+     m_numActive (0)
+{
+}
+
+JammingCoordinator::~JammingCoordinator ()
+{
+}
+
+void
+JammingCoordinator::AddJammer (Ptr<Jammer> jammer)
+{
+  NS_LOG_FUNCTION (this << jammer);
+  NS_ASSERT (jammer != NULL);
+
+  // JammerHelper aggregates the jammer to its node, which has one source
+  Ptr<EnergySourceContainer> sources;
+  Ptr<Node> node = jammer->GetObject<Node> ();
+  if (node != NULL)
+    {
+      sources = node->GetObject<EnergySourceContainer> ();
+    }
+  if (sources == NULL || sources->GetN () == 0)
+    {
+      NS_FATAL_ERROR ("JammingCoordinator:Energy source of jammer #" <<
+                      jammer->GetId () << " doesn't exist!");
+    }
+
+  JammerState state;
+  state.jammer = jammer;
+  state.source = sources->Get (0);
+  state.lastEnergy = state.source->GetRemainingEnergy ();
+  state.score = 0.0;
+  state.cost = 0.0;
+  state.tried = false;
+  m_jammers.push_back (state);
+}
+
+void
+JammingCoordinator::AddJammers (JammerContainer jammers)
+{
+  NS_LOG_FUNCTION (this);
+  for (JammerContainer::Iterator i = jammers.Begin (); i != jammers.End (); ++i)
+    {
+      AddJammer (*i);
+    }
+}
+
+void
+JammingCoordinator::AddTarget (Ptr<WirelessModuleUtility> utility)
+{
+  NS_LOG_FUNCTION (this << utility);
+  NS_ASSERT (utility != NULL);
+  TargetState target;
+  target.utility = utility;
+  target.lastReceived = utility->GetReceivedPkts ();
+  target.lastValid = utility->GetReceivedValidPkts ();
+  m_targets.push_back (target);
+}
+
+void
+JammingCoordinator::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_startTime = Simulator::Now ();
+  for (uint32_t i = 0; i < m_jammers.size (); i++)
+    {
+      m_jammers[i].lastEnergy = m_jammers[i].source->GetRemainingEnergy ();
+    }
+  double degradation;
+  MeasureTargetDegradation (degradation); // packets before the start do not count
+  m_decideEvent.Cancel ();
+  m_decideEvent = Simulator::ScheduleNow (&JammingCoordinator::Decide, this);
+}
+
+void
+JammingCoordinator::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_decideEvent.Cancel ();
+  for (uint32_t i = 0; i < m_jammers.size (); i++)
+    {
+      if (m_jammers[i].jammer->IsJammerOn ())
+        {
+          m_jammers[i].jammer->StopJammer ();
+        }
+    }
+  m_numActive = 0;
+}
+
+void
+JammingCoordinator::SetEnergyBudget (double budget)
+{
+  NS_LOG_FUNCTION (this << budget);
+  m_energyBudget = budget;
+}
+
+double
+JammingCoordinator::GetEnergyBudget (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_energyBudget;
+}
+
+void
+JammingCoordinator::SetInterval (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  NS_ASSERT (interval.IsStrictlyPositive ());
+  m_interval = interval;
+}
+
+Time
+JammingCoordinator::GetInterval (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_interval;
+}
+
+void
+JammingCoordinator::SetHorizon (Time horizon)
+{
+  NS_LOG_FUNCTION (this << horizon);
+  m_horizon = horizon;
+}
+
+Time
+JammingCoordinator::GetHorizon (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_horizon;
+}
+
+void
+JammingCoordinator::SetMaxActive (uint32_t maxActive)
+{
+  NS_LOG_FUNCTION (this << maxActive);
+  m_maxActive = maxActive;
+}
+
+uint32_t
+JammingCoordinator::GetMaxActive (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_maxActive;
+}
+
+void
+JammingCoordinator::SetAlpha (double alpha)
+{
+  NS_LOG_FUNCTION (this << alpha);
+  m_alpha = alpha;
+}
+
+double
+JammingCoordinator::GetAlpha (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_alpha;
+}
+
+double
+JammingCoordinator::GetEnergySpent (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_energySpent;
+}
+
+uint32_t
+JammingCoordinator::GetNumActive (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_numActive;
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+JammingCoordinator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_decideEvent.Cancel ();
+  m_jammers.clear ();
+  m_targets.clear ();
+}
+
+bool
+JammingCoordinator::MeasureTargetDegradation (double &degradation)
+{
+  degradation = 0.0;
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < m_targets.size (); i++)
+    {
+      TargetState &target = m_targets[i];
+      uint64_t received = target.utility->GetReceivedPkts ();
+      uint64_t valid = target.utility->GetReceivedValidPkts ();
+      if (received > target.lastReceived)
+        {
+          degradation += 1.0 - (double) (valid - target.lastValid) /
+            (double) (received - target.lastReceived);
+          count++;
+        }
+      target.lastReceived = received;
+      target.lastValid = valid;
+    }
+  if (count == 0)
+    {
+      return false;
+    }
+  degradation /= count;
+  return true;
+}
+
+void
+JammingCoordinator::Decide (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  /*
+   * Account the last interval, credit degradation to the jammers that were
+   * on. Without packets at the targets there is nothing to credit, scores
+   * keep their estimates.
+   */
+  double degradation;
+  bool measured = MeasureTargetDegradation (degradation);
+  uint32_t active = 0;
+  for (uint32_t i = 0; i < m_jammers.size (); i++)
+    {
+      active += m_jammers[i].jammer->IsJammerOn ();
+    }
+  for (uint32_t i = 0; i < m_jammers.size (); i++)
+    {
+      JammerState &state = m_jammers[i];
+      double remaining = state.source->GetRemainingEnergy ();
+      double used = std::max (0.0, state.lastEnergy - remaining);
+      state.lastEnergy = remaining;
+      if (!state.jammer->IsJammerOn ())
+        {
+          continue; // energy used while stopped is not charged
+        }
+      m_energySpent += used;
+      double credit = degradation / active;
+      if (state.tried)
+        {
+          if (measured)
+            {
+              state.score += m_alpha * (credit - state.score);
+            }
+          state.cost += m_alpha * (used - state.cost);
+        }
+      else if (measured)
+        {
+          state.score = credit;
+          state.cost = used;
+          state.tried = true;
+        }
+    }
+
+  double left = m_energyBudget - m_energySpent;
+  if (left <= 0.0)
+    {
+      NS_LOG_DEBUG ("JammingCoordinator:Budget spent, " << m_energySpent <<
+                    " J, stopping all jammers at " << Simulator::Now ().GetSeconds () << "s");
+      Stop ();
+      m_allocationTrace (0, m_energySpent, degradation);
+      return;
+    }
+
+  // share of the remaining budget for the next interval
+  double allowance = left;
+  if (m_horizon.IsStrictlyPositive ())
+    {
+      Time end = m_startTime + m_horizon;
+      double intervals = ceil ((end - Simulator::Now ()).GetSeconds () /
+                               m_interval.GetSeconds ());
+      allowance = left / std::max (1.0, intervals);
+    }
+
+  /*
+   * Untried jammers first, at the mean cost of the tried ones, then by
+   * degradation per Joule. Greedy fill of the allowance.
+   */
+  double knownCost = 0.0;
+  uint32_t known = 0;
+  std::vector<std::pair<double, uint32_t> > order;
+  order.reserve (m_jammers.size ());
+  for (uint32_t i = 0; i < m_jammers.size (); i++)
+    {
+      const JammerState &state = m_jammers[i];
+      if (state.tried)
+        {
+          knownCost += state.cost;
+          known++;
+        }
+      double ratio = state.tried ?
+        state.score / std::max (state.cost, 1e-12) : HUGE_VAL;
+      order.push_back (std::make_pair (-ratio, i));
+    }
+  std::sort (order.begin (), order.end ());
+  double defaultCost = known > 0 ? knownCost / known : 0.0;
+
+  std::vector<bool> selected (m_jammers.size (), false);
+  double planned = 0.0;
+  uint32_t chosen = 0;
+  for (uint32_t k = 0; k < order.size (); k++)
+    {
+      if (m_maxActive != 0 && chosen >= m_maxActive)
+        {
+          break;
+        }
+      const JammerState &state = m_jammers[order[k].second];
+      double cost = state.tried ? state.cost : defaultCost;
+      if (planned + cost > allowance)
+        {
+          continue;
+        }
+      selected[order[k].second] = true;
+      planned += cost;
+      chosen++;
+    }
+
+  for (uint32_t i = 0; i < m_jammers.size (); i++)
+    {
+      Ptr<Jammer> jammer = m_jammers[i].jammer;
+      if (selected[i] && !jammer->IsJammerOn ())
+        {
+          jammer->StartJammer ();
+        }
+      else if (!selected[i] && jammer->IsJammerOn ())
+        {
+          jammer->StopJammer ();
+        }
+    }
+  m_numActive = chosen;
+
+  NS_LOG_DEBUG ("JammingCoordinator:At " << Simulator::Now ().GetSeconds () <<
+                "s, degradation = " << degradation << ", spent = " <<
+                m_energySpent << " J, allowance = " << allowance << " J, " <<
+                chosen << " of " << m_jammers.size () << " jammers on");
+  m_allocationTrace (chosen, m_energySpent, degradation);
+
+  m_decideEvent = Simulator::Schedule (m_interval, &JammingCoordinator::Decide, this);
+}
+
+} // namespace ns3
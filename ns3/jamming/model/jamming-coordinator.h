@@ -0,0 +1,168 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMING_COORDINATOR_H
+#define JAMMING_COORDINATOR_H
+
+#include "jammer.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "ns3/jammer-container.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Jamming Coordinator.
+ *
+ * Splits a shared energy budget among a set of jammers. Every interval the
+ * coordinator measures the energy each active jammer used and the PDR of the
+ * packets the target nodes received in that interval, credits the PDR
+ * degradation to the active jammers, and then
+ * picks the jammers with the most degradation per Joule that fit into this
+ * interval's share of the remaining budget. Jammers are switched with
+ * Jammer::StartJammer and Jammer::StopJammer, and all are stopped once the
+ * budget is spent.
+ *
+ * Jammers that were never active are tried first. Energy a jammer uses while
+ * stopped is not charged to the budget. A decision costs O(J log J) for J
+ * jammers plus O(T) for T targets, whatever the simulation length.
+ */
+class JammingCoordinator : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  JammingCoordinator ();
+  virtual ~JammingCoordinator ();
+
+  /**
+   * \param jammer Jammer to coordinate, installed by JammerHelper.
+   */
+  void AddJammer (Ptr<Jammer> jammer);
+
+  /**
+   * \param jammers Jammers to coordinate, as returned by JammerHelper::Install.
+   */
+  void AddJammers (JammerContainer jammers);
+
+  /**
+   * \param utility WirelessModuleUtility of a node whose PDR is to be degraded.
+   */
+  void AddTarget (Ptr<WirelessModuleUtility> utility);
+
+  /**
+   * Starts coordinating, the first decision is made immediately.
+   */
+  void Start (void);
+
+  /**
+   * Stops coordinating and all coordinated jammers.
+   */
+  void Stop (void);
+
+  // setter & getters of attributes
+  void SetEnergyBudget (double budget);
+  double GetEnergyBudget (void) const;
+  void SetInterval (Time interval);
+  Time GetInterval (void) const;
+  void SetHorizon (Time horizon);
+  Time GetHorizon (void) const;
+  void SetMaxActive (uint32_t maxActive);
+  uint32_t GetMaxActive (void) const;
+  void SetAlpha (double alpha);
+  double GetAlpha (void) const;
+
+  /**
+   * \returns Energy used by coordinated jammers while active, in Joules.
+   */
+  double GetEnergySpent (void) const;
+
+  /**
+   * \returns Number of jammers switched on by the last decision.
+   */
+  uint32_t GetNumActive (void) const;
+
+  /**
+   * TracedCallback signature for allocation decisions.
+   *
+   * \param [in] active Number of jammers switched on.
+   * \param [in] spent Energy spent so far, in Joules.
+   * \param [in] degradation PDR degradation at targets over the last
+   * interval, 0 if no target received a packet in it.
+   */
+  typedef void (* AllocationTracedCallback)(uint32_t active, double spent,
+                                            double degradation);
+
+private:
+  /**
+   * Per-jammer estimates.
+   */
+  struct JammerState
+  {
+    Ptr<Jammer> jammer;
+    Ptr<EnergySource> source;
+    double lastEnergy;  // remaining energy at the last decision, in Joules
+    double score;       // EWMA of PDR degradation credited per interval
+    double cost;        // EWMA of energy used per active interval, in Joules
+    bool tried;         // true once the jammer was active for an interval
+  };
+
+  /**
+   * Per-target packet counts at the last decision.
+   */
+  struct TargetState
+  {
+    Ptr<WirelessModuleUtility> utility;
+    uint64_t lastReceived;  // packets received at the last decision
+    uint64_t lastValid;     // valid packets received at the last decision
+  };
+
+  void DoDispose (void);
+
+  /**
+   * Accounts the last interval and switches jammers for the next one.
+   */
+  void Decide (void);
+
+  /**
+   * \param degradation Set to the mean of (1 - PDR) over targets that
+   * received packets since the last call, each PDR taken over those packets
+   * only.
+   * \returns False if no target received a packet since the last call.
+   */
+  bool MeasureTargetDegradation (double &degradation);
+
+private:
+  std::vector<JammerState> m_jammers;
+  std::vector<TargetState> m_targets;
+  double m_energyBudget;      // total energy budget, in Joules
+  Time m_interval;            // decision interval
+  Time m_horizon;             // time to spread the budget over, 0 for none
+  uint32_t m_maxActive;       // max jammers on at once, 0 for no limit
+  double m_alpha;             // EWMA weight of the latest interval
+  double m_energySpent;       // energy used while active, in Joules
+  uint32_t m_numActive;       // jammers switched on by the last decision
+  Time m_startTime;           // time coordinating started
+  EventId m_decideEvent;      // next decision
+
+  TracedCallback<uint32_t, double, double> m_allocationTrace;
+
+};
+
+} // namespace ns3
+
+#endif /* JAMMING_COORDINATOR_H */
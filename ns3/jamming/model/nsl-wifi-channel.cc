@@ -10,7 +10,13 @@
 #include "nsl-wifi-channel.h"
 #include "nsl-wifi-phy.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/wifi-utils.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 
 
@@ -19,6 +25,60 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("NslWifiChannel");
 NS_OBJECT_ENSURE_REGISTERED (NslWifiChannel);
 
+/**
+ * \param loss first model of a loss model chain
+ * \param linear also require the RX power to follow the TX power dB for dB
+ * \return true if every model of the chain is deterministic, with a loss
+ * that only grows with distance
+ */
+static bool
+IsDistanceLoss (Ptr<PropagationLossModel> loss, bool linear)
+{
+  for (; loss != 0; loss = loss->GetNext ())
+    {
+      std::string name = loss->GetInstanceTypeId ().GetName ();
+      if (name == "ns3::RangePropagationLossModel" && !linear)
+        {
+          continue;
+        }
+      if (name != "ns3::FriisPropagationLossModel" &&
+          name != "ns3::LogDistancePropagationLossModel" &&
+          name != "ns3::ThreeLogDistancePropagationLossModel" &&
+          name != "ns3::TwoRayGroundPropagationLossModel")
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+/**
+ * \param object an object
+ * \param state the values of the attributes of the object are appended here
+ */
+static void
+AppendAttributes (Ptr<const Object> object, std::ostringstream &state)
+{
+  state << object->GetInstanceTypeId ().GetName () << "{";
+  for (TypeId tid = object->GetInstanceTypeId (); tid.HasParent (); tid = tid.GetParent ())
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ())
+            {
+              continue;
+            }
+          Ptr<AttributeValue> value = info.checker->Create ();
+          if (info.accessor->Get (PeekPointer (object), *value))
+            {
+              state << info.name << "=" << value->SerializeToString (info.checker) << ";";
+            }
+        }
+    }
+  state << "}";
+}
+
 TypeId
 NslWifiChannel::GetTypeId (void)
 {
@@ -34,19 +94,85 @@ NslWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&NslWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("SpatialCulling", "Skip receivers that are out of range of a transmission.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&NslWifiChannel::m_spatialCulling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxRange", "Distance beyond which no PHY receives, in meters. "
+                   "0 to derive it from the propagation loss model.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&NslWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("CullingCellSize", "Size of the grid cells used for spatial culling, in meters.",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&NslWifiChannel::m_cellSize),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("LinkCache", "Cache propagation delay and path gain per sender and receiver "
+                   "while both are static. Only used with deterministic loss models and "
+                   "the constant speed delay model.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&NslWifiChannel::m_linkCache),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BatchDelivery", "Deliver each transmission with a single pending event that "
+                   "visits the receivers in arrival order, instead of one event per receiver.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NslWifiChannel::m_batchDelivery),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CopyPerReceiver", "Hand every receiving PHY its own copy of a packet "
+                   "instead of sharing one. Only useful to measure what sharing saves.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NslWifiChannel::m_copyPerReceiver),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 NslWifiChannel::NslWifiChannel ()
+  : m_gridDirty (true),
+    m_rxThresholdDbm (0.0),
+    m_modelsChecked (false),
+    m_cacheableModels (false),
+    m_modelsValidated (Seconds (-1)),
+    m_thresholdValidated (Seconds (-1))
 {
   NS_LOG_FUNCTION (this);
+  m_courseChanged = MakeCallback (&NslWifiChannel::CourseChanged, this);
+  m_probeFrom = CreateObject<ConstantPositionMobilityModel> ();
+  m_probeTo = CreateObject<ConstantPositionMobilityModel> ();
 }
 
 NslWifiChannel::~NslWifiChannel ()
 {
   NS_LOG_FUNCTION (this);
   m_phyList.clear ();
+  m_phyBuckets.clear ();
+  m_grids.clear ();
+  m_unplaced.clear ();
+  m_trackedMobility.clear ();
+  m_links.clear ();
+}
+
+void
+NslWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the mobility models may outlive the channel
+  for (std::set<Ptr<MobilityModel> >::const_iterator i = m_trackedMobility.begin ();
+       i != m_trackedMobility.end (); i++)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange", m_courseChanged);
+    }
+  m_trackedMobility.clear ();
+  m_phyList.clear ();
+  m_phyBuckets.clear ();
+  m_grids.clear ();
+  m_unplaced.clear ();
+  m_links.clear ();
+  m_loss = 0;
+  m_delay = 0;
+  m_probeFrom = 0;
+  m_probeTo = 0;
+  Channel::DoDispose ();
 }
 
 void
@@ -54,6 +180,8 @@ NslWifiChannel::SetPropagationLossModel (const Ptr<PropagationLossModel> loss)
 {
   NS_LOG_FUNCTION (this << loss);
   m_loss = loss;
+  m_gridDirty = true;
+  InvalidateLinkCache ();
 }
 
 void
@@ -61,6 +189,7 @@ NslWifiChannel::SetPropagationDelayModel (const Ptr<PropagationDelayModel> delay
 {
   NS_LOG_FUNCTION (this << delay);
   m_delay = delay;
+  InvalidateLinkCache ();
 }
 
 void
@@ -70,42 +199,57 @@ NslWifiChannel::Send (Ptr<NslWifiPhy> sender, Ptr<const Packet> packet, double t
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
   NS_LOG_FUNCTION (sender->GetChannelNumber());
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  PhyList receivers;
+  GetReceivers (sender, txPowerDbm, receivers);
+  Ptr<Delivery> delivery;
+  if (m_batchDelivery)
+    {
+      delivery = Create<Delivery> ();
+      delivery->packet = packet;
+      delivery->duration = duration;
+      delivery->preamble = preamble;
+      delivery->txVector = txVector;
+      delivery->copy = m_copyPerReceiver;
+      delivery->arrivals.reserve (receivers.size ());
+    }
+  for (PhyList::const_iterator i = receivers.begin (); i != receivers.end (); i++)
     {
-      if (sender != (*i))
+      Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+      Time delay;
+      double rxPowerDbm;
+      GetLink (sender, *i, txPowerDbm, delay, rxPowerDbm);
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+      Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
+      uint32_t dstNode;
+      if (dstNetDevice == 0)
         {
-          //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
-
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetNode ()->GetId ();
-            }
+          dstNode = 0xffffffff;
+        }
+      else
+        {
+          dstNode = dstNetDevice->GetNode ()->GetId ();
+        }
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &NslWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm, duration,preamble,txVector);
+      if (delivery != 0)
+        {
+          AddArrival (delivery, *i, dstNode, delay, rxPowerDbm);
+          continue;
         }
+      // all receivers share the packet, NslWifiPhy copies it before modifying
+      Simulator::ScheduleWithContext (dstNode,
+                                      delay, &NslWifiChannel::Receive,
+                                      (*i), m_copyPerReceiver ? packet->Copy () : packet,
+                                      rxPowerDbm, duration,preamble,txVector);
+    }
+  if (delivery != 0)
+    {
+      ScheduleDelivery (delivery);
     }
 }
 
 void
-NslWifiChannel::Receive (Ptr<NslWifiPhy> phy, Ptr<Packet> packet, double rxPowerDbm, Time duration, WifiPreamble preamble,WifiTxVector txVector)
+NslWifiChannel::Receive (Ptr<NslWifiPhy> phy, Ptr<const Packet> packet, double rxPowerDbm, Time duration, WifiPreamble preamble,WifiTxVector txVector)
 {
   NS_LOG_FUNCTION (phy << packet << rxPowerDbm << duration.GetSeconds ());
   // Do no further processing if signal is too weak
@@ -119,6 +263,120 @@ NslWifiChannel::Receive (Ptr<NslWifiPhy> phy, Ptr<Packet> packet, double rxPower
   phy->StartReceivePacket (packet, rxPowerDbm, txVector,preamble);
 }
 
+void
+NslWifiChannel::SendSignal (Ptr<NslWifiPhy> sender, double txPowerDbm, Time duration) const
+{
+  NS_LOG_FUNCTION (this << sender << txPowerDbm << duration.GetSeconds ());
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  NS_ASSERT (senderMobility != 0);
+  PhyList receivers;
+  GetReceivers (sender, txPowerDbm, receivers);
+  Ptr<Delivery> delivery;
+  if (m_batchDelivery)
+    {
+      delivery = Create<Delivery> ();
+      delivery->duration = duration;
+      delivery->copy = false;
+      delivery->arrivals.reserve (receivers.size ());
+    }
+  for (PhyList::const_iterator i = receivers.begin (); i != receivers.end (); i++)
+    {
+      Time delay;
+      double rxPowerDbm;
+      GetLink (sender, *i, txPowerDbm, delay, rxPowerDbm);
+      Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
+      uint32_t dstNode = dstNetDevice == 0 ? 0xffffffff : dstNetDevice->GetNode ()->GetId ();
+
+      if (delivery != 0)
+        {
+          AddArrival (delivery, *i, dstNode, delay, rxPowerDbm);
+          continue;
+        }
+      Simulator::ScheduleWithContext (dstNode, delay, &NslWifiChannel::ReceiveSignal,
+                                      (*i), rxPowerDbm, duration);
+    }
+  if (delivery != 0)
+    {
+      ScheduleDelivery (delivery);
+    }
+}
+
+void
+NslWifiChannel::AddArrival (Ptr<Delivery> delivery, Ptr<NslWifiPhy> phy, uint32_t context,
+                            Time delay, double rxPowerDbm)
+{
+  // kept even below the RX sensitivity, Receive and ReceiveSignal check it at
+  // arrival time as they do without batching
+  Arrival arrival;
+  arrival.phy = phy;
+  arrival.time = Simulator::Now () + delay;
+  arrival.context = context;
+  arrival.rxPowerDbm = rxPowerDbm;
+  delivery->arrivals.push_back (arrival);
+}
+
+void
+NslWifiChannel::ScheduleDelivery (Ptr<Delivery> delivery)
+{
+  std::vector<Arrival> &arrivals = delivery->arrivals;
+  if (arrivals.empty ())
+    {
+      return;
+    }
+  // by time, then node, so that one event serves a node's PHYs arriving together
+  std::stable_sort (arrivals.begin (), arrivals.end (),
+                    [] (const Arrival &a, const Arrival &b)
+                    {
+                      return a.time < b.time || (a.time == b.time && a.context < b.context);
+                    });
+  delivery->next = 0;
+  Simulator::ScheduleWithContext (arrivals[0].context, arrivals[0].time - Simulator::Now (),
+                                  &NslWifiChannel::Deliver, delivery);
+}
+
+void
+NslWifiChannel::Deliver (Ptr<Delivery> delivery)
+{
+  NS_LOG_FUNCTION (delivery);
+  const std::vector<Arrival> &arrivals = delivery->arrivals;
+  Time now = Simulator::Now ();
+  uint32_t context = arrivals[delivery->next].context;
+  // this event runs in the context of the node the arrivals are for
+  while (delivery->next < arrivals.size () &&
+         arrivals[delivery->next].time == now &&
+         arrivals[delivery->next].context == context)
+    {
+      const Arrival &arrival = arrivals[delivery->next++];
+      if (delivery->packet != 0)
+        {
+          Receive (arrival.phy, delivery->copy ? delivery->packet->Copy () : delivery->packet,
+                   arrival.rxPowerDbm, delivery->duration, delivery->preamble, delivery->txVector);
+        }
+      else
+        {
+          ReceiveSignal (arrival.phy, arrival.rxPowerDbm, delivery->duration);
+        }
+    }
+  if (delivery->next < arrivals.size ())
+    {
+      const Arrival &arrival = arrivals[delivery->next];
+      Simulator::ScheduleWithContext (arrival.context, arrival.time - now,
+                                      &NslWifiChannel::Deliver, delivery);
+    }
+}
+
+void
+NslWifiChannel::ReceiveSignal (Ptr<NslWifiPhy> phy, double rxPowerDbm, Time duration)
+{
+  NS_LOG_FUNCTION (phy << rxPowerDbm << duration.GetSeconds ());
+  if ((rxPowerDbm + phy->GetRxGain ()) < phy->GetRxSensitivity ())
+    {
+      NS_LOG_INFO ("Received signal too weak to process: " << rxPowerDbm << " dBm");
+      return;
+    }
+  phy->StartReceiveSignal (rxPowerDbm, duration);
+}
+
 std::size_t
 NslWifiChannel::GetNDevices (void) const
 {
@@ -136,6 +394,25 @@ NslWifiChannel::Add (Ptr<NslWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  m_phyBuckets[phy->GetChannelNumber ()].push_back (phy);
+  m_gridDirty = true;
+  m_thresholdValidated = Seconds (-1);
+}
+
+void
+NslWifiChannel::UpdateChannelNumber (Ptr<NslWifiPhy> phy, uint16_t previous)
+{
+  NS_LOG_FUNCTION (this << phy << previous << phy->GetChannelNumber ());
+  PhyList &from = m_phyBuckets[previous];
+  PhyList::iterator i = std::find (from.begin (), from.end (), phy);
+  NS_ASSERT (i != from.end ());
+  from.erase (i);
+  if (from.empty ())
+    {
+      m_phyBuckets.erase (previous);
+    }
+  m_phyBuckets[phy->GetChannelNumber ()].push_back (phy);
+  m_gridDirty = true;
 }
 
 int64_t
@@ -147,6 +424,275 @@ NslWifiChannel::AssignStreams (int64_t stream)
   return (currentStream - stream);
 }
 
+double
+NslWifiChannel::GetMaxRange (double txPowerDbm) const
+{
+  if (m_maxRange > 0)
+    {
+      return m_maxRange;
+    }
+  ValidateModels ();
+  if (m_gridDirty)
+    {
+      BuildGrid ();
+    }
+  ValidateRxThreshold ();
+  // first distance whose loss already puts the signal below every threshold
+  double maxLossDb = txPowerDbm - m_rxThresholdDbm;
+  std::size_t k = 0;
+  while (k < m_lossTable.size () && m_lossTable[k].second <= maxLossDb)
+    {
+      k++;
+    }
+  return k < m_lossTable.size () ? m_lossTable[k].first : -1;
+}
+
+void
+NslWifiChannel::GetReceivers (Ptr<NslWifiPhy> sender, double txPowerDbm, PhyList &receivers) const
+{
+  //For now don't account for inter channel interference nor channel bonding
+  uint16_t channelNumber = sender->GetChannelNumber ();
+  PhyBuckets::const_iterator bucket = m_phyBuckets.find (channelNumber);
+  if (bucket == m_phyBuckets.end ())
+    {
+      return;
+    }
+
+  // a derived range validates the models first, which may dirty the grid
+  double range = m_spatialCulling ? GetMaxRange (txPowerDbm) : -1;
+  if (m_spatialCulling && m_gridDirty)
+    {
+      BuildGrid ();
+    }
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  int64_t span = range < 0 ? 0 : static_cast<int64_t> (std::ceil (range / m_cellSize));
+  // fall back to the whole bucket when the grid would not save anything
+  if (range < 0 || (2 * span + 1) * (2 * span + 1) >= (int64_t) bucket->second.size ())
+    {
+      receivers.reserve (bucket->second.size ());
+      for (PhyList::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++)
+        {
+          if (sender != (*i) && (range < 0 || (*i)->GetMobility () == 0 ||
+                                 senderMobility->GetDistanceFrom ((*i)->GetMobility ()) <= range))
+            {
+              receivers.push_back (*i);
+            }
+        }
+      return;
+    }
+
+  const Grid &grid = m_grids[channelNumber];
+  Cell center = GetCell (senderMobility->GetPosition ());
+  for (int64_t x = center.first - span; x <= center.first + span; x++)
+    {
+      for (int64_t y = center.second - span; y <= center.second + span; y++)
+        {
+          Grid::const_iterator cell = grid.find (Cell (x, y));
+          if (cell == grid.end ())
+            {
+              continue;
+            }
+          for (PhyList::const_iterator i = cell->second.begin (); i != cell->second.end (); i++)
+            {
+              if (sender != (*i) &&
+                  senderMobility->GetDistanceFrom ((*i)->GetMobility ()) <= range)
+                {
+                  receivers.push_back (*i);
+                }
+            }
+        }
+    }
+  // PHYs without a fixed position are only culled by distance
+  const PhyList &unplaced = m_unplaced[channelNumber];
+  for (PhyList::const_iterator i = unplaced.begin (); i != unplaced.end (); i++)
+    {
+      if (sender != (*i) && ((*i)->GetMobility () == 0 ||
+                             senderMobility->GetDistanceFrom ((*i)->GetMobility ()) <= range))
+        {
+          receivers.push_back (*i);
+        }
+    }
+}
+
+void
+NslWifiChannel::BuildGrid (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_gridDirty = false;
+  m_grids.clear ();
+  m_unplaced.clear ();
+
+  for (PhyBuckets::const_iterator bucket = m_phyBuckets.begin (); bucket != m_phyBuckets.end (); bucket++)
+    {
+      // create every bucket's entries here, lookups from Send do not insert
+      Grid &grid = m_grids[bucket->first];
+      PhyList &unplaced = m_unplaced[bucket->first];
+      for (PhyList::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++)
+        {
+          Ptr<MobilityModel> mobility = (*i)->GetMobility ();
+          TrackMobility (mobility);
+          // moving PHYs leave their cell between course changes
+          if (mobility == 0 || CalculateDistance (mobility->GetVelocity (), Vector ()) > 0)
+            {
+              unplaced.push_back (*i);
+              continue;
+            }
+          grid[GetCell (mobility->GetPosition ())].push_back (*i);
+        }
+    }
+
+  // loss over distance, only for single models known to grow with distance
+  m_lossTable.clear ();
+  if (m_loss == 0 || m_loss->GetNext () != 0 || !IsDistanceLoss (m_loss, false))
+    {
+      NS_LOG_DEBUG ("no max range for this loss model, spatial culling disabled");
+      return;
+    }
+  for (double distance = 1.0; distance < 1e7; distance *= 1.1)
+    {
+      m_lossTable.push_back (std::make_pair (distance, GetProbeLoss (distance)));
+    }
+}
+
+double
+NslWifiChannel::GetProbeLoss (double distance) const
+{
+  m_probeTo->SetPosition (Vector (distance, 0, 0));
+  return -m_loss->CalcRxPower (0.0, m_probeFrom, m_probeTo);
+}
+
+NslWifiChannel::Cell
+NslWifiChannel::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+NslWifiChannel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+  m_gridDirty = true;
+  m_links.clear ();
+}
+
+void
+NslWifiChannel::TrackMobility (Ptr<MobilityModel> mobility) const
+{
+  if (mobility != 0 && m_trackedMobility.insert (mobility).second)
+    {
+      mobility->TraceConnectWithoutContext ("CourseChange", m_courseChanged);
+    }
+}
+
+std::string
+NslWifiChannel::GetModelState (void) const
+{
+  std::ostringstream state;
+  for (Ptr<PropagationLossModel> loss = m_loss; loss != 0; loss = loss->GetNext ())
+    {
+      AppendAttributes (loss, state);
+    }
+  if (m_delay != 0)
+    {
+      AppendAttributes (m_delay, state);
+    }
+  return state.str ();
+}
+
+void
+NslWifiChannel::ValidateModels (void) const
+{
+  Time now = Simulator::Now ();
+  if (now == m_modelsValidated)
+    {
+      return;
+    }
+  m_modelsValidated = now;
+  std::string state = GetModelState ();
+  if (state != m_modelState)
+    {
+      NS_LOG_DEBUG ("propagation model attributes changed, rebuilding the grid and dropping cached links");
+      m_modelState = state;
+      m_gridDirty = true;
+      m_links.clear ();
+      m_modelsChecked = false;
+    }
+}
+
+void
+NslWifiChannel::ValidateRxThreshold (void) const
+{
+  Time now = Simulator::Now ();
+  if (now == m_thresholdValidated)
+    {
+      return;
+    }
+  m_thresholdValidated = now;
+  // the PHYs do not report changes of their RX sensitivity or gain
+  m_rxThresholdDbm = HUGE_VAL;
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+    {
+      m_rxThresholdDbm = std::min (m_rxThresholdDbm,
+                                   (*i)->GetRxSensitivity () - (*i)->GetRxGain ());
+    }
+}
+
+void
+NslWifiChannel::InvalidateLinkCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_links.clear ();
+  m_modelsChecked = false;
+}
+
+void
+NslWifiChannel::GetLink (Ptr<NslWifiPhy> sender, Ptr<NslWifiPhy> receiver, double txPowerDbm,
+                         Time &delay, double &rxPowerDbm) const
+{
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+  if (m_linkCache)
+    {
+      ValidateModels ();
+    }
+  if (m_linkCache && !m_modelsChecked)
+    {
+      // loss chains are completed after SetPropagationLossModel, check on use
+      m_cacheableModels = IsDistanceLoss (m_loss, true) && m_delay != 0 &&
+        m_delay->GetInstanceTypeId ().GetName () == "ns3::ConstantSpeedPropagationDelayModel";
+      m_modelsChecked = true;
+    }
+  if (!m_linkCache || !m_cacheableModels)
+    {
+      delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      return;
+    }
+
+  LinkKey key (PeekPointer (sender), PeekPointer (receiver));
+  LinkMap::const_iterator link = m_links.find (key);
+  if (link == m_links.end ())
+    {
+      Link entry;
+      entry.delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      entry.gainDb = m_loss->CalcRxPower (0.0, senderMobility, receiverMobility);
+      // moving ends change the link between course changes, do not keep it
+      if (CalculateDistance (senderMobility->GetVelocity (), Vector ()) > 0 ||
+          CalculateDistance (receiverMobility->GetVelocity (), Vector ()) > 0)
+        {
+          delay = entry.delay;
+          rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+          return;
+        }
+      TrackMobility (senderMobility);
+      TrackMobility (receiverMobility);
+      link = m_links.insert (std::make_pair (key, entry)).first;
+    }
+  delay = link->second.delay;
+  rxPowerDbm = txPowerDbm + link->second.gainDb;
+}
+
 
 
 } //namespace ns3
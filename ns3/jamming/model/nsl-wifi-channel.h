@@ -22,15 +22,25 @@
 #define NSL_WIFI_CHANNEL_H
 
 #include "ns3/channel.h"
+#include "ns3/callback.h"
 #include "ns3/wifi-preamble.h"
 #include "ns3/wifi-tx-vector.h"
 #include "ns3/interference-helper.h"
+#include "ns3/vector.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 namespace ns3 {
 
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
 class NslWifiPhy;
+class MobilityModel;
 class Packet;
 class Time;
 
@@ -42,6 +52,43 @@ class Time;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * With SpatialCulling enabled, PHYs are kept in a uniform grid over their
+ * positions and a transmission skips receivers beyond the distance at which
+ * its signal is certain to be below every PHY's RX sensitivity. That range
+ * is MaxRange if set, or else derived from the loss model when it is a
+ * single deterministic model whose loss grows with distance (Friis,
+ * LogDistance, ThreeLogDistance, TwoRayGround, Range). For any other loss
+ * model no receiver is skipped. The grid is rebuilt after PHYs are added,
+ * switch channel or report a mobility course change. A change of the loss
+ * model attributes rebuilds the grid too. The loss model attributes and the
+ * lowest RX sensitivity less RX gain of the PHYs are read again at most once
+ * per simulation time, so changes made after a transmission apply from the
+ * next simulation time on.
+ *
+ * With LinkCache enabled, the delay and path gain of each sender and receiver
+ * pair are computed once and reused while both are static. The cache is only
+ * used when every loss model of the chain is deterministic with an RX power
+ * that follows the TX power (Friis, LogDistance, ThreeLogDistance,
+ * TwoRayGround) and the delay model is ConstantSpeed. It is cleared on any
+ * mobility course change, when a model is replaced and when the attributes
+ * of an attached model change. Attributes are compared at most once per
+ * simulation time, so a change is picked up by the first lookup at a later
+ * time.
+ *
+ * With BatchDelivery enabled, a transmission keeps a single pending event in
+ * the scheduler rather than one per receiver. The event runs at the next
+ * arrival, in the context of the receiving node, delivers every arrival due
+ * then for that node and reschedules itself for the following one. Arrival
+ * times and contexts are unchanged, and the RX sensitivity is checked at
+ * arrival time as without batching, so a PHY whose sensitivity changes while
+ * the signal travels sees the same outcome. Events of other sources due at
+ * the same time as an arrival may run in a different order than without
+ * batching.
+ *
+ * A packet is shared by all its receivers, a PHY only copies it once it
+ * synchronizes on it. CopyPerReceiver restores a copy per receiver, to
+ * measure the difference.
  */
 class NslWifiChannel : public Channel
 {
@@ -66,6 +113,15 @@ public:
    */
   void Add (Ptr<NslWifiPhy> phy);
 
+  /**
+   * Moves the given PHY to the bucket of its current channel number.
+   * Called by NslWifiPhy whenever its channel number changes.
+   *
+   * \param phy the PHY whose channel number changed
+   * \param previous the channel number the PHY was on before
+   */
+  void UpdateChannelNumber (Ptr<NslWifiPhy> phy, uint16_t previous);
+
   /**
    * \param loss the new propagation loss model.
    */
@@ -84,9 +140,19 @@ public:
    * This method should not be invoked by normal users. It is
    * currently invoked only from YansWifiPhy::StartTx.  The channel
    * attempts to deliver the packet to all other YansWifiPhy objects
-   * on the channel (except for the sender).
+   * on the channel (except for the sender). Only PHYs on the sender's
+   * channel number are visited.
    */
   void Send (Ptr<NslWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm, Time duration, WifiPreamble preamble,WifiTxVector txVector) const;
+  /**
+   * \param sender the phy object from which the signal is originating.
+   * \param txPowerDbm the tx power of the signal, in dBm
+   * \param duration the duration of the signal
+   *
+   * Delivers a payload-free jamming signal to all other PHYs on the same
+   * channel number. Only power and duration travel, no packet is created.
+   */
+  void SendSignal (Ptr<NslWifiPhy> sender, double txPowerDbm, Time duration) const;
   void EndReceive (Ptr<Packet> packet, Ptr<Event> event);
   /**
    * Assign a fixed random variable stream number to the random variables
@@ -99,12 +165,141 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \param txPowerDbm the tx power of a transmission, in dBm
+   * \return the distance beyond which no PHY can receive the transmission,
+   * in meters, or a negative value if it is unbounded
+   */
+  double GetMaxRange (double txPowerDbm) const;
+
+  /**
+   * \param sender the transmitting PHY
+   * \param receiver the receiving PHY
+   * \param txPowerDbm the tx power (dBm)
+   * \param delay set to the propagation delay from sender to receiver
+   * \param rxPowerDbm set to the received power (dBm)
+   *
+   * Uses the link cache when enabled and applicable.
+   */
+  void GetLink (Ptr<NslWifiPhy> sender, Ptr<NslWifiPhy> receiver, double txPowerDbm,
+                Time &delay, double &rxPowerDbm) const;
+
+  /**
+   * Drops all cached links. Attribute changes of the propagation models are
+   * picked up without it, from the next simulation time on.
+   */
+  void InvalidateLinkCache (void);
+
+protected:
+  // Inherited
+  virtual void DoDispose (void);
 
 private:
   /**
    * A vector of pointers to YansWifiPhy.
    */
   typedef std::vector<Ptr<NslWifiPhy> > PhyList;
+  /**
+   * PHYs grouped by channel number.
+   */
+  typedef std::map<uint16_t, PhyList> PhyBuckets;
+  /**
+   * Grid cell coordinates.
+   */
+  typedef std::pair<int64_t, int64_t> Cell;
+  /**
+   * PHYs of one channel number by grid cell.
+   */
+  typedef std::map<Cell, PhyList> Grid;
+
+  /**
+   * Collects the PHYs a transmission from the sender may reach: the PHYs on
+   * the sender's channel number, less the sender and, with culling, the PHYs
+   * out of range.
+   *
+   * \param sender the transmitting PHY
+   * \param txPowerDbm the tx power of the transmission (dBm)
+   * \param receivers filled with the candidate receivers
+   */
+  void GetReceivers (Ptr<NslWifiPhy> sender, double txPowerDbm, PhyList &receivers) const;
+
+  /**
+   * Rebuilds the grids and the loss table.
+   */
+  void BuildGrid (void) const;
+
+  /**
+   * \param distance a distance (m)
+   * \return the loss of the loss model over the distance (dB)
+   */
+  double GetProbeLoss (double distance) const;
+
+  /**
+   * \return the attribute values of the loss model chain and the delay model
+   */
+  std::string GetModelState (void) const;
+
+  /**
+   * Compares the attributes of the propagation models with the ones last
+   * seen, at most once per simulation time. If they changed, the grid is
+   * marked for rebuilding, which recomputes the loss table, and the cached
+   * links are dropped.
+   */
+  void ValidateModels (void) const;
+
+  /**
+   * Recomputes the lowest RX sensitivity less RX gain of all PHYs, at most
+   * once per simulation time.
+   */
+  void ValidateRxThreshold (void) const;
+
+  /**
+   * \param position a position
+   * \return the grid cell containing the position
+   */
+  Cell GetCell (const Vector &position) const;
+
+  /**
+   * Marks the grid for rebuilding, connected to CourseChange of every PHY
+   * mobility model.
+   *
+   * \param mobility the mobility model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+
+  /**
+   * Connects CourseChanged to the given mobility model, once.
+   *
+   * \param mobility the mobility model, may be null
+   */
+  void TrackMobility (Ptr<MobilityModel> mobility) const;
+
+  /**
+   * Delay and path gain of a sender and receiver pair.
+   */
+  struct Link
+  {
+    Time delay;     //!< Propagation delay
+    double gainDb;  //!< RX power less TX power (dB)
+  };
+  /**
+   * Sender and receiver of a link.
+   */
+  typedef std::pair<const NslWifiPhy *, const NslWifiPhy *> LinkKey;
+  /**
+   * Hash of a LinkKey.
+   */
+  struct LinkKeyHash
+  {
+    std::size_t operator() (const LinkKey &key) const
+    {
+      return std::hash<const void *> () (key.first) * 31 + std::hash<const void *> () (key.second);
+    }
+  };
+  /**
+   * Cached links.
+   */
+  typedef std::unordered_map<LinkKey, Link, LinkKeyHash> LinkMap;
 
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
@@ -116,9 +311,90 @@ private:
    * \param txPowerDbm the tx power associated to the packet being sent (dBm)
    * \param duration the transmission duration associated with the packet being sent
    */
-  static void Receive (Ptr<NslWifiPhy> receiver, Ptr<Packet> packet, double txPowerDbm, Time duration,WifiPreamble preamble,WifiTxVector txVector);
+  static void Receive (Ptr<NslWifiPhy> receiver, Ptr<const Packet> packet, double txPowerDbm, Time duration,WifiPreamble preamble,WifiTxVector txVector);
+
+  /**
+   * This method is scheduled by SendSignal for each PHY on the channel.
+   *
+   * \param receiver the PHY the signal arrives at
+   * \param rxPowerDbm the received power of the signal (dBm)
+   * \param duration the duration of the signal
+   */
+  static void ReceiveSignal (Ptr<NslWifiPhy> receiver, double rxPowerDbm, Time duration);
+
+  /**
+   * Arrival of a transmission at one PHY.
+   */
+  struct Arrival
+  {
+    Ptr<NslWifiPhy> phy;  //!< Receiving PHY
+    Time time;            //!< Arrival time
+    uint32_t context;     //!< Node id of the receiving PHY
+    double rxPowerDbm;    //!< Received power (dBm)
+  };
+  /**
+   * A transmission delivered by a single pending event.
+   */
+  class Delivery : public SimpleRefCount<Delivery>
+  {
+  public:
+    Ptr<const Packet> packet;        //!< Packet, 0 for a jamming signal
+    Time duration;                   //!< Transmission duration
+    WifiPreamble preamble;           //!< Preamble of the packet
+    WifiTxVector txVector;           //!< TX vector of the packet
+    std::vector<Arrival> arrivals;   //!< Arrivals, ordered by time once scheduled
+    std::size_t next;                //!< Next arrival to deliver
+    bool copy;                       //!< Copy the packet for every receiver
+  };
+
+  /**
+   * Adds an arrival to a batched delivery.
+   *
+   * \param delivery the delivery
+   * \param phy the receiving PHY
+   * \param context node id of the receiving PHY
+   * \param delay the propagation delay
+   * \param rxPowerDbm the received power (dBm)
+   */
+  static void AddArrival (Ptr<Delivery> delivery, Ptr<NslWifiPhy> phy, uint32_t context,
+                          Time delay, double rxPowerDbm);
+  /**
+   * Orders the arrivals of a delivery and schedules the first.
+   *
+   * \param delivery the delivery
+   */
+  static void ScheduleDelivery (Ptr<Delivery> delivery);
+  /**
+   * Delivers the arrivals due now for the context of this event and
+   * schedules the next.
+   *
+   * \param delivery the delivery
+   */
+  static void Deliver (Ptr<Delivery> delivery);
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
+  PhyBuckets m_phyBuckets;             //!< Connected PHYs by channel number
+  bool m_spatialCulling;               //!< Skip receivers out of range
+  double m_maxRange;                   //!< Configured max range (m), 0 to derive
+  double m_cellSize;                   //!< Grid cell size (m)
+  mutable bool m_gridDirty;            //!< Grid needs rebuilding
+  mutable std::map<uint16_t, Grid> m_grids;       //!< Grid per channel number
+  mutable std::map<uint16_t, PhyList> m_unplaced; //!< PHYs without a fixed position per channel number
+  mutable double m_rxThresholdDbm;     //!< Lowest RX sensitivity less RX gain of all PHYs
+  mutable std::vector<std::pair<double, double> > m_lossTable; //!< (distance, loss dB), empty if not derivable
+  mutable std::set<Ptr<MobilityModel> > m_trackedMobility;   //!< Mobility models connected to CourseChanged
+  Callback<void, Ptr<const MobilityModel> > m_courseChanged; //!< CourseChanged bound to this channel
+  Ptr<MobilityModel> m_probeFrom;      //!< Origin of the loss table distances
+  Ptr<MobilityModel> m_probeTo;        //!< End of the loss table distances
+  bool m_linkCache;                    //!< Cache delay and path gain per link
+  mutable bool m_modelsChecked;        //!< m_cacheableModels is up to date
+  mutable bool m_cacheableModels;      //!< Propagation models allow caching
+  mutable LinkMap m_links;             //!< Cached links
+  mutable Time m_modelsValidated;      //!< Time of the last ValidateModels
+  mutable std::string m_modelState;    //!< Attribute values seen by ValidateModels
+  mutable Time m_thresholdValidated;   //!< Time of the last ValidateRxThreshold
+  bool m_batchDelivery;                //!< One pending event per transmission
+  bool m_copyPerReceiver;              //!< Copy packets for every receiver
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
 };
@@ -28,6 +28,8 @@
 #include "ns3/wifi-phy-tag.h"
 #include "ns3/wifi-phy-header.h"
 #include "ns3/ampdu-tag.h"
+#include "ns3/ampdu-subframe-header.h"
+#include "ns3/header.h"
 #include "ns3/wifi-utils.h"
 
 NS_LOG_COMPONENT_DEFINE("NslWifiPhy");
@@ -37,6 +39,116 @@ namespace ns3
 
   NS_OBJECT_ENSURE_REGISTERED(NslWifiPhy);
 
+  /**
+   * Deserializes a header found some bytes into a packet, so that the SIG
+   * headers of a packet shared by all receivers can be peeked one after the
+   * other. Only used with Packet::PeekHeader.
+   */
+  class OffsetHeader : public Header
+  {
+  public:
+    /**
+     * \param header the header to deserialize
+     * \param offset the bytes before the header
+     */
+    OffsetHeader(Header &header, uint32_t offset)
+        : m_header(header),
+          m_offset(offset)
+    {
+    }
+    virtual TypeId GetInstanceTypeId(void) const
+    {
+      return m_header.GetInstanceTypeId();
+    }
+    virtual void Print(std::ostream &os) const
+    {
+      m_header.Print(os);
+    }
+    virtual uint32_t GetSerializedSize(void) const
+    {
+      return m_offset + m_header.GetSerializedSize();
+    }
+    virtual void Serialize(Buffer::Iterator start) const
+    {
+      NS_FATAL_ERROR("OffsetHeader is only peeked");
+    }
+    virtual uint32_t Deserialize(Buffer::Iterator start)
+    {
+      start.Next(m_offset);
+      return m_header.Deserialize(start);
+    }
+
+  private:
+    Header &m_header;  //!< Header to deserialize
+    uint32_t m_offset; //!< Bytes before the header
+  };
+
+  /**
+   * \param packet the received packet
+   * \param offset the bytes of the SIG headers peeked so far, increased by
+   *        the size of this one
+   * \param header the SIG header to peek
+   * \return true if the header was found
+   */
+  static bool
+  PeekSigHeader(Ptr<const Packet> packet, uint32_t &offset, Header &header)
+  {
+    OffsetHeader offsetHeader(header, offset);
+    uint32_t size = packet->PeekHeader(offsetHeader);
+    offset += size;
+    return size != 0;
+  }
+
+  /**
+   * IsAmpdu for a packet still carrying its SIG headers.
+   *
+   * \param packet the received packet
+   * \param offset the bytes of its SIG headers
+   * \return true if the payload is an A-MPDU
+   */
+  static bool
+  IsAmpduAfter(Ptr<const Packet> packet, uint32_t offset)
+  {
+    // the metadata is searched whatever the position of the subframe header
+    if (packet->BeginItem().HasNext())
+    {
+      return IsAmpdu(packet);
+    }
+    AmpduSubframeHeader hdr;
+    OffsetHeader offsetHeader(hdr, offset);
+    uint32_t deserialized = packet->PeekHeader(offsetHeader);
+    return deserialized == hdr.GetSerializedSize() && hdr.IsSignatureValid() &&
+           hdr.GetLength() <= packet->GetSize() - offset - deserialized;
+  }
+
+  /**
+   * \param packet the received packet
+   * \param sigSize the bytes of its SIG headers
+   * \return a copy of the packet without PHY tag and SIG headers, sharing
+   *         the payload bytes
+   */
+  static Ptr<Packet>
+  CopyFrame(Ptr<const Packet> packet, uint32_t sigSize)
+  {
+    Ptr<Packet> frame = packet->Copy();
+    WifiPhyTag tag;
+    frame->RemovePacketTag(tag);
+    frame->RemoveAtStart(sigSize);
+    return frame;
+  }
+
+  /**
+   * \param packet the received packet
+   * \param tagged whether it carries a PHY tag and SIG headers
+   * \param sigSize the bytes of its SIG headers
+   * \return the frame as the MAC sees it, the packet itself if untagged
+   */
+  static Ptr<const Packet>
+  FrameView(Ptr<const Packet> packet, bool tagged, uint32_t sigSize)
+  {
+    return tagged ? CopyFrame(packet, sigSize) : packet;
+  }
+
   TypeId
   NslWifiPhy::GetTypeId(void)
   {
@@ -185,6 +297,7 @@ namespace ns3
       {
         m_utility->SetRssMeasurementCallback(MakeCallback(&NslWifiPhy::MeasureRss, this));
         m_utility->SetSendPacketCallback(MakeCallback(&NslWifiPhy::UtilitySendPacket, this));
+        m_utility->SetSendSignalCallback(MakeCallback(&NslWifiPhy::UtilitySendSignal, this));
         m_utility->SetChannelSwitchCallback(MakeCallback(&NslWifiPhy::SetChannelNumber, this));
         UpdatePhyLayerInfo();
       }
@@ -224,17 +337,33 @@ namespace ns3
     }
   }
 
-  void
-  NslWifiPhy::UtilitySendPacket(Ptr<Packet> packet, double &powerW, int utilitySendMode)
+  bool
+  NslWifiPhy::UtilityPowerLevel(double &powerW, uint8_t &powerLevel)
   {
-    NS_LOG_FUNCTION(this << packet << powerW << utilitySendMode);
-
     // Convert power in Watts to a power level
-    uint8_t powerLevel;
     powerLevel = (uint8_t)(WifiPhy::GetNTxPower() * (WToDbm(powerW) - WifiPhy::GetTxPowerStart()) /
                            (WifiPhy::GetTxPowerEnd() - WifiPhy::GetTxPowerStart()));
 
     if (powerLevel >= 0 && powerLevel < WifiPhy::GetNTxPower())
+    {
+      // update the actual TX power
+      powerW = DbmToW(WifiPhy::GetTxPowerStart());
+      powerW += powerLevel * DbmToW((WifiPhy::GetTxPowerEnd() - WifiPhy::GetTxPowerStart()) / WifiPhy::GetNTxPower());
+      return true;
+    }
+    NS_LOG_DEBUG("NslWifiPhy: Node # " << m_node->GetId() << "Error in send packet callback. Incorrect power level.");
+    // set sent power to 0 to indicate error
+    powerW = 0;
+    return false;
+  }
+
+  void
+  NslWifiPhy::UtilitySendPacket(Ptr<Packet> packet, double &powerW, int utilitySendMode)
+  {
+    NS_LOG_FUNCTION(this << packet << powerW << utilitySendMode);
+
+    uint8_t powerLevel;
+    if (UtilityPowerLevel(powerW, powerLevel))
     {
       NS_LOG_DEBUG("NslWifiPhy:Inside send packet callback at node #" << m_node->GetId() << ". Sending packet.");
 
@@ -266,15 +395,19 @@ namespace ns3
       default:
         break;
       }
-      // update the actual TX power
-      powerW = DbmToW(WifiPhy::GetTxPowerStart());
-      powerW += powerLevel * DbmToW((WifiPhy::GetTxPowerEnd() - WifiPhy::GetTxPowerStart()) / WifiPhy::GetNTxPower());
     }
-    else
+  }
+
+  void
+  NslWifiPhy::UtilitySendSignal(double &powerW, Time duration)
+  {
+    NS_LOG_FUNCTION(this << powerW << duration);
+
+    uint8_t powerLevel;
+    if (UtilityPowerLevel(powerW, powerLevel))
     {
-      NS_LOG_DEBUG("NslWifiPhy: Node # " << m_node->GetId() << "Error in send packet callback. Incorrect power level.");
-      // set sent power to 0 to indicate error
-      powerW = 0;
+      NS_LOG_DEBUG("NslWifiPhy:Sending jamming signal at node #" << m_node->GetId() << " for " << duration);
+      SendSignal(duration, powerLevel);
     }
   }
 
@@ -348,6 +481,45 @@ namespace ns3
     DriverStartTx(packet, DbmToW(GetPowerDbm(txPower) + WifiPhy::GetTxGain()));
   }
 
+  /**
+   * Stands in for the jamming signal wherever the PHY and utility interfaces
+   * expect a packet: empty and shared by all bursts.
+   */
+  static Ptr<const Packet>
+  JammingSignal(void)
+  {
+    static Ptr<const Packet> signal = Create<Packet>();
+    return signal;
+  }
+
+  void
+  NslWifiPhy::SendSignal(Time duration, uint8_t txPower)
+  {
+    NS_LOG_FUNCTION(this << duration << (uint32_t)txPower);
+    NS_ASSERT(!m_state->IsStateTx() && !m_state->IsStateSwitching());
+
+    if (m_state->IsStateRx())
+    {
+      m_endRxEvent.Cancel();
+      m_interference.NotifyRxEnd();
+    }
+
+    WifiTxVector txVector;
+    txVector.SetMode(m_currentWifiMode);
+    txVector.SetPreambleType(WIFI_PREAMBLE_INVALID);
+    txVector.SetTxPowerLevel(txPower);
+
+    double txPowerDbm = GetPowerDbm(txPower) + WifiPhy::GetTxGain();
+    NotifyTxBegin(JammingSignal(), DbmToW(txPowerDbm));
+    m_state->SwitchToTx(duration, JammingSignal(), GetPowerDbm(txPower), txVector);
+    m_channel->SendSignal(this, txPowerDbm, duration);
+
+    /*
+     * Driver interface.
+     */
+    DriverStartTx(JammingSignal(), DbmToW(txPowerDbm));
+  }
+
   void
   NslWifiPhy::DriverStartTx(Ptr<const Packet> packet, double txPower)
   {
@@ -365,6 +537,28 @@ namespace ns3
     Simulator::Schedule(m_state->GetDelayUntilIdle(), &NslWifiPhy::DriverEndTx, this, packet, txPower);
   }
 
+  void
+  NslWifiPhy::DriverSignalStart(Time duration)
+  {
+    NS_LOG_FUNCTION(this << duration);
+    // without PeriodicRss, the utility only samples RSS on receptions
+    if (m_utility != NULL)
+    {
+      m_utility->SignalChangeHandler();
+      Simulator::Schedule(duration, &NslWifiPhy::DriverSignalEnd, this);
+    }
+  }
+
+  void
+  NslWifiPhy::DriverSignalEnd(void)
+  {
+    NS_LOG_FUNCTION(this);
+    if (m_utility != NULL)
+    {
+      m_utility->SignalChangeHandler();
+    }
+  }
+
   void
   NslWifiPhy::DriverEndTx(Ptr<const Packet> packet, double txPower)
   {
@@ -400,7 +594,12 @@ namespace ns3
     {
       // this is not channel switch, this is initialization
       NS_LOG_DEBUG("start at channel " << nch);
+      uint16_t previous = m_channelNumber;
       m_channelNumber = nch;
+      if (m_channel != 0 && previous != nch)
+      {
+        m_channel->UpdateChannelNumber(this, previous);
+      }
       return;
     }
     NS_LOG_DEBUG(m_state->GetState());
@@ -451,7 +650,12 @@ namespace ns3
      * state are added to the event list and are employed later to figure
      * out the state of the medium after the switching.
      */
+    uint16_t previous = m_channelNumber;
     m_channelNumber = nch;
+    if (m_channel != 0 && previous != nch)
+    {
+      m_channel->UpdateChannelNumber(this, previous);
+    }
 
     /*
      * Driver interface.
@@ -497,7 +701,7 @@ namespace ns3
   }
 
   void
-  NslWifiPhy::StartReceivePacket(Ptr<Packet> packet,
+  NslWifiPhy::StartReceivePacket(Ptr<const Packet> packet,
                                  double rxPowerDbm,
                                  WifiTxVector txMode,
                                  uint16_t preamble)
@@ -511,17 +715,19 @@ namespace ns3
 
     // extract tag
     WifiPhyTag tag;
-    bool found = packet->RemovePacketTag(tag);
+    bool tagged = packet->PeekPacketTag(tag);
+    uint32_t sigSize = 0;
 
-    // handle modulation
-    if (found)
+    // handle modulation, the packet is shared by all receivers, only peek
+    if (tagged)
     {
+      bool found;
       WifiTxVector txVector = txMode;
       WifiModulationClass modulation = tag.GetModulation();
       if ((modulation == WIFI_MOD_CLASS_DSSS) || (modulation == WIFI_MOD_CLASS_HR_DSSS))
       {
         DsssSigHeader dsssSigHdr;
-        found = packet->RemoveHeader(dsssSigHdr);
+        found = PeekSigHeader(packet, sigSize, dsssSigHdr);
         if (!found)
         {
           NS_FATAL_ERROR("Received 802.11b signal with no SIG field");
@@ -541,7 +747,7 @@ namespace ns3
       else if ((modulation != WIFI_MOD_CLASS_HT) || (preamble != WIFI_PREAMBLE_HT_GF))
       {
         LSigHeader lSigHdr;
-        found = packet->RemoveHeader(lSigHdr);
+        found = PeekSigHeader(packet, sigSize, lSigHdr);
         if (!found)
         {
           NS_FATAL_ERROR("Received OFDM 802.11 signal with no SIG field");
@@ -562,7 +768,7 @@ namespace ns3
       if (modulation == WIFI_MOD_CLASS_HT)
       {
         HtSigHeader htSigHdr;
-        found = packet->RemoveHeader(htSigHdr);
+        found = PeekSigHeader(packet, sigSize, htSigHdr);
         if (!found)
         {
           NS_FATAL_ERROR("Received 802.11n signal with no HT-SIG field");
@@ -586,7 +792,7 @@ namespace ns3
       {
         VhtSigHeader vhtSigHdr;
         vhtSigHdr.SetMuFlag(preamble == WIFI_PREAMBLE_VHT_MU);
-        found = packet->RemoveHeader(vhtSigHdr);
+        found = PeekSigHeader(packet, sigSize, vhtSigHdr);
         if (!found)
         {
           NS_FATAL_ERROR("Received 802.11ac signal with no VHT-SIG field");
@@ -604,7 +810,7 @@ namespace ns3
           }
         }
         txVector.SetGuardInterval(vhtSigHdr.GetShortGuardInterval() ? 400 : 800);
-        if (IsAmpdu(packet))
+        if (IsAmpduAfter(packet, sigSize))
         {
           txVector.SetAggregation(true);
         }
@@ -613,7 +819,7 @@ namespace ns3
       {
         HeSigHeader heSigHdr;
         heSigHdr.SetMuFlag(preamble == WIFI_PREAMBLE_HE_MU);
-        found = packet->RemoveHeader(heSigHdr);
+        found = PeekSigHeader(packet, sigSize, heSigHdr);
         if (!found)
         {
           NS_FATAL_ERROR("Received 802.11ax signal with no HE-SIG field");
@@ -632,7 +838,7 @@ namespace ns3
         }
         txVector.SetGuardInterval(heSigHdr.GetGuardInterval());
         txVector.SetBssColor(heSigHdr.GetBssColor());
-        if (IsAmpdu(packet))
+        if (IsAmpduAfter(packet, sigSize))
         {
           txVector.SetAggregation(true);
         }
@@ -654,7 +860,7 @@ namespace ns3
     {
     case WifiPhyState::SWITCHING:
       NS_LOG_DEBUG("NslWifiPhy:drop packet because of channel switching");
-      NotifyRxDrop(packet, NOT_ALLOWED);
+      NotifyRxDrop(FrameView(packet, tagged, sigSize), NOT_ALLOWED);
       /*
        * Packets received on the upcoming channel are added to the event list
        * during the switching state. This way the medium can be correctly sensed
@@ -672,7 +878,7 @@ namespace ns3
       break;
     case WifiPhyState::RX:
       NS_LOG_DEBUG("NslWifiPhy:drop packet because already in Rx (power = " << rxPowerW << " W)");
-      NotifyRxDrop(packet, NOT_ALLOWED);
+      NotifyRxDrop(FrameView(packet, tagged, sigSize), NOT_ALLOWED);
       if (endRx > Simulator::Now() + m_state->GetDelayUntilIdle())
       {
         // that packet will be noise _after_ the reception of the
@@ -682,7 +888,7 @@ namespace ns3
       break;
     case WifiPhyState::TX:
       NS_LOG_DEBUG("NslWifiPhy:drop packet because already in Tx (power = " << rxPowerW << " W)");
-      NotifyRxDrop(packet, NOT_ALLOWED);
+      NotifyRxDrop(FrameView(packet, tagged, sigSize), NOT_ALLOWED);
       if (endRx > Simulator::Now() + m_state->GetDelayUntilIdle())
       {
         // that packet will be noise _after_ the transmission of the
@@ -701,42 +907,45 @@ namespace ns3
         if (preamble == WIFI_PREAMBLE_INVALID)
         {
           NS_LOG_DEBUG("NslWifiPhy:drop **jamming** packet!" << packet);
-          NotifyRxDrop(packet, NOT_ALLOWED);
+          NotifyRxDrop(FrameView(packet, tagged, sigSize), NOT_ALLOWED);
           goto maybeCcaBusy;
         }
 
+        // a copy of our own without tag and SIG, the payload stays shared
+        Ptr<Packet> rxPacket = CopyFrame(packet, sigSize);
+
         /*
          * Driver interface.
          */
-        if (!DriverStartRx(packet, MeasureRss()))
+        if (!DriverStartRx(rxPacket, MeasureRss()))
         {
           NS_LOG_DEBUG("NslWifiPhy:Ignoring RX! at Node #" << m_node->GetId());
-          NotifyRxDrop(packet, NOT_ALLOWED);
+          NotifyRxDrop(rxPacket, NOT_ALLOWED);
           return; // still in IDLE or CCA_BUSY
         }
 
         // sync to signal
         m_state->SwitchToRx(rxDuration);
         NS_ASSERT(m_endRxEvent.IsExpired());
-        NotifyRxBegin(packet);
+        NotifyRxBegin(rxPacket);
         m_interference.NotifyRxStart();
         m_endRxEvent = Simulator::Schedule(rxDuration, &NslWifiPhy::EndReceive,
-                                           this, packet, event);
+                                           this, rxPacket, event);
       }
       else // drop because power too low
       {
         NS_LOG_DEBUG("NslWifiPhy:drop packet because signal power too Small (" << rxPowerW << "<" << -140 << ")");
-        NotifyRxDrop(packet, NOT_ALLOWED);
+        NotifyRxDrop(FrameView(packet, tagged, sigSize), NOT_ALLOWED);
         goto maybeCcaBusy;
       }
       break;
     case WifiPhyState::SLEEP:
       NS_LOG_DEBUG("Drop packet because in sleep mode");
-      NotifyRxDrop(packet, NOT_ALLOWED);
+      NotifyRxDrop(FrameView(packet, tagged, sigSize), NOT_ALLOWED);
       break;
     case WifiPhyState::OFF:
       NS_LOG_DEBUG("Drop packet because in sleep mode");
-      NotifyRxDrop(packet, NOT_ALLOWED);
+      NotifyRxDrop(FrameView(packet, tagged, sigSize), NOT_ALLOWED);
       WifiPhy::ResumeFromOff();
       break;
     }
@@ -747,6 +956,7 @@ namespace ns3
     // not going to be able to synchronize on it
     // In this model, CCA becomes busy when the aggregation of all signals as
     // tracked by the InterferenceHelper class is higher than the CcaBusyThreshold
+    DriverSignalStart(rxDuration);
 
     // WifiPhy::SwitchMaybeToCcaBusy();
 
@@ -757,6 +967,46 @@ namespace ns3
     }
   }
 
+  void
+  NslWifiPhy::StartReceiveSignal(double rxPowerDbm, Time duration)
+  {
+    NS_LOG_FUNCTION(this << rxPowerDbm << duration);
+    double rxPowerW = DbmToW(rxPowerDbm + WifiPhy::GetRxGain());
+    Time endRx = Simulator::Now() + duration;
+
+    // a jamming signal is never synchronized on, it only adds interference
+    m_interference.AddForeignSignal(duration, rxPowerW);
+    DriverSignalStart(duration);
+
+    switch (m_state->GetState())
+    {
+    case WifiPhyState::SWITCHING:
+    case WifiPhyState::RX:
+    case WifiPhyState::TX:
+      if (endRx <= Simulator::Now() + m_state->GetDelayUntilIdle())
+      {
+        // over before the current switch, reception or transmission is
+        return;
+      }
+      break;
+    case WifiPhyState::CCA_BUSY:
+    case WifiPhyState::IDLE:
+      break;
+    case WifiPhyState::SLEEP:
+      return;
+    case WifiPhyState::OFF:
+      WifiPhy::ResumeFromOff();
+      return;
+    }
+
+    // same CCA rule as for a dropped jamming packet in StartReceivePacket
+    Time delayUntilCcaEnd = m_interference.GetEnergyDuration(250);
+    if (!delayUntilCcaEnd.IsZero())
+    {
+      m_state->SwitchMaybeToCcaBusy(delayUntilCcaEnd);
+    }
+  }
+
   void
   NslWifiPhy::EndReceive(Ptr<Packet> packet, Ptr<Event> event)
   {
@@ -764,11 +1014,6 @@ namespace ns3
     // NS_ASSERT (IsStateRx ());
     NS_ASSERT(event->GetEndTime() == Simulator::Now());
 
-    /*
-     * Make a copy of the original packet to pass to WirelessModuleUtility.
-     */
-    Ptr<Packet> copy = packet->Copy();
-
     struct InterferenceHelper::SnrPer snrPer;
     snrPer = m_interference.CalculateSnrPer(event);
     m_interference.NotifyRxEnd();
@@ -792,9 +1037,10 @@ namespace ns3
       SignalNoiseDbm noiseDbm2 = rxInfo.second;
       statusPerMpdu.push_back(rxInfo.first);
       NotifyMonitorSniffRx(packet, (uint16_t)GetChannelFrequencyMhz(), event->GetTxVector(), noiseDbm2, statusPerMpdu);
-      m_state->SwitchFromRxEndOk(packet, snrPer.snr, event->GetTxVector(), statusPerMpdu);
+      // the MAC removes its headers, WirelessModuleUtility reads the frame after it
+      m_state->SwitchFromRxEndOk(packet->Copy(), snrPer.snr, event->GetTxVector(), statusPerMpdu);
 
-      DriverEndRx(copy, snrPer.packetRss, true);
+      DriverEndRx(packet, snrPer.packetRss, true);
     }
     else
     {
@@ -806,12 +1052,12 @@ namespace ns3
        * Driver interface.
        */
 
-      DriverEndRx(copy, snrPer.packetRss, false);
+      DriverEndRx(packet, snrPer.packetRss, false);
     }
   }
 
   void
-  NslWifiPhy::DriverEndRx(Ptr<Packet> packet, double averageRssW,
+  NslWifiPhy::DriverEndRx(Ptr<const Packet> packet, double averageRssW,
                           const bool isSuccessfullyReceived)
   {
     NS_LOG_FUNCTION(this << packet << averageRssW << isSuccessfullyReceived);
@@ -819,7 +1065,8 @@ namespace ns3
     // notify utility for end of RX
     if (m_utility != 0)
     {
-      m_utility->EndRxHandler(packet, averageRssW, isSuccessfullyReceived);
+      // the PHY keeps using the frame, the utility must not modify it
+      m_utility->EndRxHandler(ConstCast<Packet>(packet), averageRssW, isSuccessfullyReceived);
     }
     else
     {
@@ -828,7 +1075,7 @@ namespace ns3
   }
 
   bool
-  NslWifiPhy::DriverStartRx(Ptr<Packet> packet, double startRssW)
+  NslWifiPhy::DriverStartRx(Ptr<const Packet> packet, double startRssW)
   {
 
     NS_LOG_FUNCTION(this << packet << startRssW);
@@ -838,7 +1085,8 @@ namespace ns3
     // notify utility for start of RX
     if (m_utility != NULL)
     {
-      isPacketToBeReceived = m_utility->StartRxHandler(packet, startRssW);
+      // the PHY keeps using the frame, the utility must not modify it
+      isPacketToBeReceived = m_utility->StartRxHandler(ConstCast<Packet>(packet), startRssW);
     }
     else
     {
@@ -85,6 +85,9 @@ public:
  
 
   void UtilitySendPacket (Ptr<Packet> packet, double &powerW, int utilitySendMode);
+  void UtilitySendSignal (double &powerW, Time duration);
+  void SendSignal (Time duration, uint8_t txPowerLevel);
+  void StartReceiveSignal (double rxPowerDbm, Time duration);
   void SendPacket (Ptr<const Packet> packet, WifiTxVector txMode, WifiPreamble preamble, uint8_t txPowerLevel);
   //double GetEdThresholdW (void) const;
   double DbmToW (double dbm) const;
@@ -92,7 +95,7 @@ public:
   void DriverStartTx (Ptr<const Packet> packet, double txPower);
   double GetRxNoiseFigure (void) const;
   
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            double rxPowerDbm,
                            WifiTxVector mode,
                            uint16_t preamble);
@@ -102,10 +105,10 @@ public:
   void InitDriver (void);
   void DriverEndTx (Ptr<const Packet> packet, double txPower);
    void SetCurrentWifiMode (WifiMode mode);
-    bool DriverStartRx (Ptr<Packet> packet, double startRssW);
+    bool DriverStartRx (Ptr<const Packet> packet, double startRssW);
     void EndReceive (Ptr<Packet> packet, Ptr<Event> event);
   double GetChannelFrequencyMhz() const;
-   void DriverEndRx (Ptr<Packet> packet, double averageRssW,
+   void DriverEndRx (Ptr<const Packet> packet, double averageRssW,
                     const bool isSuccessfullyReceived);
   uint16_t GetChannelNumber () const;
 
@@ -115,6 +118,18 @@ protected:
   // Inherited
   virtual void DoDispose (void);
   void UpdatePhyLayerInfo (void);
+  bool UtilityPowerLevel (double &powerW, uint8_t &powerLevel);
+  /**
+   * Lets the utility account the busy time of a signal the PHY does not
+   * synchronize on, now and once more when the signal ends.
+   *
+   * \param duration the duration of the signal
+   */
+  void DriverSignalStart (Time duration);
+  /**
+   * Lets the utility account the busy time at the end of such a signal.
+   */
+  void DriverSignalEnd (void);
 
 
 
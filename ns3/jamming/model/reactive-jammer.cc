@@ -24,6 +24,7 @@
 #include "ns3/log.h"
 #include "ns3/double.h"
 #include "ns3/uinteger.h"
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("ReactiveJammer");
 
@@ -82,11 +83,25 @@ ReactiveJammer::GetTypeId (void)
                    MakeUintegerAccessor (&ReactiveJammer::SetReactToMitigation,
                                          &ReactiveJammer::GetReactToMitigation),
                    MakeUintegerChecker<bool> ())
+    .AddAttribute ("ReactiveJammerRandomBatchSize",
+                   "Number of uniform variates drawn at once for jamming decisions. "
+                   "Decisions do not depend on the batch size.",
+                   UintegerValue (256),
+                   MakeUintegerAccessor (&ReactiveJammer::SetRandomBatchSize,
+                                         &ReactiveJammer::GetRandomBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Decision",
+                     "Jamming decision for every packet whose reception started.",
+                     MakeTraceSourceAccessor (&ReactiveJammer::m_decisionTrace),
+                     "ns3::ReactiveJammer::DecisionTracedCallback")
   ;
   return tid;
 }
 
 ReactiveJammer::ReactiveJammer ():
+    m_decisionThreshold (-1),
+    m_variateIndex (0),
+    m_randomBatchSize (256),
     m_reactToMitigation (false)
 {
    m_random = CreateObject<UniformRandomVariable> ();
@@ -212,6 +227,66 @@ ReactiveJammer::GetReactToMitigation (void) const
   return m_reactToMitigation;
 }
 
+void
+ReactiveJammer::SetRandomBatchSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (size > 0);
+  // buffered variates are kept, the new size applies from the next refill
+  m_randomBatchSize = size;
+}
+
+uint32_t
+ReactiveJammer::GetRandomBatchSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_randomBatchSize;
+}
+
+uint32_t
+ReactiveJammer::DecidePackets (uint32_t count, uint8_t *decisions)
+{
+  NS_LOG_FUNCTION (this << count);
+  double threshold = GetDecisionThreshold ();
+  uint32_t jammed = 0;
+  uint32_t i = 0;
+  while (i < count)
+    {
+      if (m_variateIndex == m_variates.size ())
+        {
+          RefillVariates ();
+        }
+      if (threshold != m_decisionThreshold)
+        {
+          DecideVariates (threshold);
+        }
+      uint32_t n = std::min<uint32_t> (count - i, m_variates.size () - m_variateIndex);
+      const uint8_t *decided = &m_decisions[m_variateIndex];
+      for (uint32_t j = 0; j < n; j++)
+        {
+          decisions[i + j] = decided[j];
+          jammed += decided[j];
+        }
+      m_variateIndex += n;
+      i += n;
+    }
+  NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () << ", Jamming " <<
+                jammed << " of " << count << " packets");
+  return jammed;
+}
+
+int64_t
+ReactiveJammer::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_random->SetStream (stream);
+  m_variates.clear ();
+  m_decisions.clear ();
+  m_decisionThreshold = -1;
+  m_variateIndex = 0;
+  return 1;
+}
+
 /*
  * Private functions start here.
  */
@@ -254,7 +329,9 @@ ReactiveJammer::DoStartRxHandler (Ptr<Packet> packet, double startRss)
   NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
                 ", Started receiving a packet!");
 
-  if (IsPacketToBeJammed (packet))
+  bool jam = IsPacketToBeJammed (packet);
+  m_decisionTrace (packet, jam);
+  if (jam)
     {
       NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
                     ", Decided to jam this packet!");
@@ -313,6 +390,21 @@ ReactiveJammer::IsPacketToBeJammed (Ptr<Packet> packet)
   NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
                 ", Deciding whether to react to packet!");
 
+  // make probabilistic decision based on energy fraction or fixed probability
+  if (m_reactionStrategy == FIXED_PROBABILITY)
+    {
+      // the threshold stays put, decisions come out of the batch
+      uint8_t jam;
+      DecidePackets (1, &jam);
+      return jam != 0;
+    }
+  // the energy fraction drops with every burst, compare one at a time
+  return NextVariate () < GetDecisionThreshold ();
+}
+
+double
+ReactiveJammer::GetDecisionThreshold (void) const
+{
   double energyFraction;
   switch (m_reactionStrategy)
     {
@@ -320,20 +412,57 @@ ReactiveJammer::IsPacketToBeJammed (Ptr<Packet> packet)
       energyFraction = m_source->GetEnergyFraction ();
       NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
                     ", Energy fraction = " << energyFraction);
-      // make probabilistic decision based on energy fraction
-      return (m_random->GetValue() < energyFraction);
+      return energyFraction;
     case FIXED_PROBABILITY:
       NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
                     ", Fixed probability " << m_fixedProbability);
-      // make probabilistic decision based on fixed probability
-      return (m_random->GetValue () < m_fixedProbability);
-      //return true;
+      return m_fixedProbability;
     default:
       NS_FATAL_ERROR ("ReactiveJammer:At Node #" << GetId () <<
                       ", Error! Unknown strategy of reaction.");
       break;
     }
-  return false;
+  return 0.0;
+}
+
+double
+ReactiveJammer::NextVariate (void)
+{
+  if (m_variateIndex == m_variates.size ())
+    {
+      RefillVariates ();
+    }
+  return m_variates[m_variateIndex++];
+}
+
+void
+ReactiveJammer::RefillVariates (void)
+{
+  NS_LOG_FUNCTION (this);
+  // drawn in stream order, so decisions match one GetValue () per packet
+  m_variates.resize (m_randomBatchSize);
+  for (uint32_t i = 0; i < m_randomBatchSize; i++)
+    {
+      m_variates[i] = m_random->GetValue ();
+    }
+  m_decisions.resize (m_randomBatchSize);
+  m_decisionThreshold = -1;
+  m_variateIndex = 0;
+}
+
+void
+ReactiveJammer::DecideVariates (double threshold)
+{
+  NS_LOG_FUNCTION (this << threshold);
+  // plain arrays of doubles and bytes, the compiler vectorizes the loop
+  uint32_t n = m_variates.size () - m_variateIndex;
+  const double *variates = m_variates.data () + m_variateIndex;
+  uint8_t *decisions = m_decisions.data () + m_variateIndex;
+  for (uint32_t j = 0; j < n; j++)
+    {
+      decisions[j] = variates[j] < threshold;
+    }
+  m_decisionThreshold = threshold;
 }
 
 void
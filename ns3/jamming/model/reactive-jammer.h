@@ -24,6 +24,8 @@
 #include "jammer.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -76,7 +78,43 @@ public:
   Time GetRxTimeout (void) const;
   void SetReactToMitigation (const bool flag);
   bool GetReactToMitigation (void) const;
+  void SetRandomBatchSize (uint32_t size);
+  uint32_t GetRandomBatchSize (void) const;
 
+  /**
+   * \brief Makes the jamming decision for a batch of packets.
+   *
+   * \param count Number of packets to decide on.
+   * \param decisions Buffer of at least count bytes, filled with one decision
+   * per packet, 1 to jam.
+   * \returns Number of packets to be jammed.
+   *
+   * The decision threshold (energy fraction or fixed probability) is read
+   * once for the whole batch. Decisions are made for all buffered variates
+   * at once and kept until the threshold changes. The reception path takes
+   * its decisions from the same buffers, so mixing both keeps the stream in
+   * order and the outcome does not depend on RandomBatchSize.
+   */
+  uint32_t DecidePackets (uint32_t count, uint8_t *decisions);
+
+  /**
+   * \brief Assigns a fixed stream to the decision random variable.
+   *
+   * \param stream First stream index to use.
+   * \returns Number of stream indices used.
+   *
+   * Discards any buffered variates so the next decision is drawn from the
+   * start of the new stream.
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * TracedCallback signature for jamming decisions.
+   *
+   * \param [in] packet Packet whose reception started.
+   * \param [in] jam True if the jammer reacts to it.
+   */
+  typedef void (* DecisionTracedCallback)(Ptr<const Packet> packet, bool jam);
 
 private:
   void DoDispose (void);
@@ -127,6 +165,28 @@ private:
    * be jammed based on the ReactionStrategy selected.
    */
   bool IsPacketToBeJammed (Ptr<Packet> packet);
+
+  /**
+   * \returns Probability of jamming a packet under the current strategy.
+   */
+  double GetDecisionThreshold (void) const;
+
+  /**
+   * \returns Next uniform variate from the buffer, refilled in bulk.
+   */
+  double NextVariate (void);
+
+  /**
+   * Draws a full batch of uniform variates from m_random into the buffer.
+   */
+  void RefillVariates (void);
+
+  /**
+   * \param threshold Decision threshold.
+   *
+   * Decides every buffered variate not used yet against the threshold.
+   */
+  void DecideVariates (double threshold);
   
   /**
    * \brief Reacts to packet by sending jamming signal.
@@ -150,9 +210,15 @@ private:
   ReactionStrategy m_reactionStrategy; // Reaction strategy used by the jammer.
   double m_fixedProbability;	// Used for FIXED_PROBABILITY reaction strategy
   Ptr<UniformRandomVariable> m_random;	  // Used for making probabilistic decisions for reacting to a packet
+  std::vector<double> m_variates;     // pre-drawn variates from m_random
+  std::vector<uint8_t> m_decisions;   // decision per variate at m_decisionThreshold
+  double m_decisionThreshold;         // threshold of m_decisions, negative if undecided
+  uint32_t m_variateIndex;            // next unused variate in m_variates
+  uint32_t m_randomBatchSize;         // variates drawn per refill
   Time m_rxTimeout;           // RX timeout interval
   EventId m_rxTimeoutEvent;   // RX timeout event
   bool m_reactToMitigation;   // true if jammer is reacting to mitigation
+  TracedCallback<Ptr<const Packet>, bool> m_decisionTrace;
 
 };
 
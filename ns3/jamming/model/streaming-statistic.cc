@@ -0,0 +1,173 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "streaming-statistic.h"
+#include "ns3/assert.h"
+#include <math.h>
+#include <algorithm>
+
+namespace ns3 {
+
+StreamingStatistic::StreamingStatistic (double low, double high,
+                                        uint32_t buckets, bool logScale)
+  : m_low (low),
+    m_high (high),
+    m_logScale (logScale),
+    m_alpha (0.1),
+    m_buckets (buckets, 0)
+{
+  NS_ASSERT (high > low && buckets > 0);
+  NS_ASSERT (!logScale || low > 0);
+  Reset ();
+}
+
+void
+StreamingStatistic::SetAlpha (double alpha)
+{
+  NS_ASSERT (alpha > 0 && alpha <= 1);
+  m_alpha = alpha;
+}
+
+double
+StreamingStatistic::GetAlpha (void) const
+{
+  return m_alpha;
+}
+
+void
+StreamingStatistic::Add (double value)
+{
+  if (m_count == 0)
+    {
+      m_ewma = value;
+      m_min = value;
+      m_max = value;
+    }
+  else
+    {
+      m_ewma += m_alpha * (value - m_ewma);
+      m_min = std::min (m_min, value);
+      m_max = std::max (m_max, value);
+    }
+  m_count++;
+
+  double position = Position (value);
+  uint32_t bucket = 0;
+  if (position >= m_buckets.size ())
+    {
+      bucket = m_buckets.size () - 1;
+    }
+  else if (position > 0)
+    {
+      bucket = (uint32_t) position;
+    }
+  m_buckets[bucket]++;
+}
+
+void
+StreamingStatistic::Reset (void)
+{
+  m_count = 0;
+  m_ewma = 0;
+  m_min = 0;
+  m_max = 0;
+  std::fill (m_buckets.begin (), m_buckets.end (), 0);
+}
+
+uint64_t
+StreamingStatistic::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+StreamingStatistic::GetEwma (void) const
+{
+  return m_ewma;
+}
+
+double
+StreamingStatistic::GetMin (void) const
+{
+  return m_min;
+}
+
+double
+StreamingStatistic::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+StreamingStatistic::GetPercentile (double quantile) const
+{
+  NS_ASSERT (quantile >= 0 && quantile <= 1);
+  if (m_count == 0)
+    {
+      return 0;
+    }
+
+  // rank of the wanted sample, then the bucket holding it
+  double rank = quantile * m_count;
+  uint64_t below = 0;
+  uint32_t bucket = 0;
+  while (bucket < m_buckets.size () - 1 && below + m_buckets[bucket] < rank)
+    {
+      below += m_buckets[bucket];
+      bucket++;
+    }
+
+  double fraction = 0;
+  if (m_buckets[bucket] > 0)
+    {
+      fraction = std::min (1.0, (rank - below) / m_buckets[bucket]);
+    }
+  double value = Value (bucket + fraction);
+  return std::min (m_max, std::max (m_min, value));
+}
+
+uint64_t
+StreamingStatistic::GetFootprint (void) const
+{
+  return m_buckets.capacity () * sizeof (uint64_t);
+}
+
+double
+StreamingStatistic::Position (double value) const
+{
+  if (m_logScale)
+    {
+      if (value <= m_low)
+        {
+          return 0;
+        }
+      return m_buckets.size () * log (value / m_low) / log (m_high / m_low);
+    }
+  return m_buckets.size () * (value - m_low) / (m_high - m_low);
+}
+
+double
+StreamingStatistic::Value (double position) const
+{
+  double fraction = position / m_buckets.size ();
+  if (m_logScale)
+    {
+      return m_low * pow (m_high / m_low, fraction);
+    }
+  return m_low + fraction * (m_high - m_low);
+}
+
+} // namespace ns3
@@ -0,0 +1,103 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef STREAMING_STATISTIC_H
+#define STREAMING_STATISTIC_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Fixed-memory summary of a stream of samples.
+ *
+ * Keeps the count, an exponentially weighted moving average, the minimum,
+ * the maximum and a fixed-bucket histogram from which percentiles are read.
+ * Adding a sample is O(1). Buckets cover [low, high], evenly spaced on a
+ * linear or logarithmic scale; samples outside the range fall into the first
+ * or last bucket, so percentiles are only as precise as one bucket.
+ */
+class StreamingStatistic
+{
+public:
+  /**
+   * \param low Lower edge of the histogram.
+   * \param high Upper edge of the histogram.
+   * \param buckets Number of histogram buckets.
+   * \param logScale True to space buckets logarithmically, low must be > 0.
+   */
+  StreamingStatistic (double low = 0, double high = 1, uint32_t buckets = 100,
+                      bool logScale = false);
+
+  /**
+   * \param alpha Weight of the newest sample in the EWMA, in (0, 1].
+   */
+  void SetAlpha (double alpha);
+  double GetAlpha (void) const;
+
+  /**
+   * \param value New sample.
+   */
+  void Add (double value);
+
+  /**
+   * Forgets all samples, keeps the histogram layout and alpha.
+   */
+  void Reset (void);
+
+  uint64_t GetCount (void) const;
+  double GetEwma (void) const;
+  double GetMin (void) const;
+  double GetMax (void) const;
+
+  /**
+   * \param quantile Quantile in [0, 1], e.g. 0.95 for the 95th percentile.
+   * \returns Estimated value at the quantile, interpolated within its bucket
+   * and clamped to the observed minimum and maximum. 0 without samples.
+   */
+  double GetPercentile (double quantile) const;
+
+  /**
+   * \returns Heap bytes held by the histogram.
+   */
+  uint64_t GetFootprint (void) const;
+
+private:
+  /**
+   * \returns Position of the value on the histogram scale, in buckets.
+   */
+  double Position (double value) const;
+
+  /**
+   * \returns Value at the given position on the histogram scale.
+   */
+  double Value (double position) const;
+
+  double m_low;
+  double m_high;
+  bool m_logScale;
+  double m_alpha;
+  uint64_t m_count;
+  double m_ewma;
+  double m_min;
+  double m_max;
+  std::vector<uint64_t> m_buckets;
+};
+
+} // namespace ns3
+
+#endif /* STREAMING_STATISTIC_H */
@@ -0,0 +1,458 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "sweep-jammer.h"
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include <algorithm>
+#include <ctype.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+NS_LOG_COMPONENT_DEFINE ("SweepJammer");
+
+/*
+ * Sweep Jammer
+ */
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SweepJammer);
+
+TypeId
+SweepJammer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SweepJammer")
+    .SetParent<Jammer> ()
+    .AddConstructor<SweepJammer> ()
+    .AddAttribute ("SweepJammerTxPower",
+                   "Default power to send jamming signal for sweep jammer, in Watts.",
+                   DoubleValue (0.001), // 0dBm
+                   MakeDoubleAccessor (&SweepJammer::SetTxPower,
+                                       &SweepJammer::GetTxPower),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SweepJammerDwellTime",
+                   "Default time the sweep jammer spends on a channel.",
+                   TimeValue (MilliSeconds (10.0)),
+                   MakeTimeAccessor (&SweepJammer::SetDwellTime,
+                                     &SweepJammer::GetDwellTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("SweepJammerSchedule",
+                   "Hop schedule of the sweep jammer, \"channel[:dwell[:power]]\" "
+                   "per hop separated by spaces, e.g. \"1:10ms:0.001 6:20ms 11\".",
+                   StringValue ("1 6 11"),
+                   MakeStringAccessor (&SweepJammer::SetSchedule,
+                                       &SweepJammer::GetSchedule),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+SweepJammer::SweepJammer ()
+  :  m_hopIndex (0)
+{
+}
+
+SweepJammer::~SweepJammer ()
+{
+}
+
+void
+SweepJammer::SetUtility (Ptr<WirelessModuleUtility> utility)
+{
+  NS_LOG_FUNCTION (this << utility);
+  NS_ASSERT (utility != NULL);
+  m_utility = utility;
+}
+
+void
+SweepJammer::SetEnergySource (Ptr<EnergySource> source)
+{
+  NS_LOG_FUNCTION (this << source);
+  NS_ASSERT (source != NULL);
+  m_source = source;
+}
+
+void
+SweepJammer::SetTxPower (double power)
+{
+  NS_LOG_FUNCTION (this << power);
+  m_txPower = power;
+}
+
+double
+SweepJammer::GetTxPower (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_txPower;
+}
+
+void
+SweepJammer::SetDwellTime (Time dwell)
+{
+  NS_LOG_FUNCTION (this << dwell);
+  m_dwellTime = dwell;
+}
+
+Time
+SweepJammer::GetDwellTime (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_dwellTime;
+}
+
+void
+SweepJammer::SetSchedule (std::string schedule)
+{
+  NS_LOG_FUNCTION (this << schedule);
+  m_schedule = schedule;
+}
+
+std::string
+SweepJammer::GetSchedule (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_schedule;
+}
+
+void
+SweepJammer::AddHop (uint16_t channel, Time dwell, double power)
+{
+  NS_LOG_FUNCTION (this << channel << dwell << power);
+  Hop hop;
+  hop.channel = channel;
+  hop.dwell = dwell;
+  hop.power = power;
+  m_addedHops.push_back (hop);
+}
+
+void
+SweepJammer::ClearHops (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_addedHops.clear ();
+}
+
+bool
+SweepJammer::ParseSchedule (std::string schedule, Time dwell, double power,
+                            std::vector<Hop> &hops)
+{
+  NS_LOG_FUNCTION (schedule << dwell << power);
+  static const char *units[] = {"", "s", "ms", "us", "ns", "ps", "fs", "min", "h", "d", "y"};
+
+  std::istringstream tokens (schedule);
+  std::string token;
+  while (tokens >> token)
+    {
+      std::istringstream fields (token);
+      std::string channel, dwellField, powerField, extra;
+      std::getline (fields, channel, ':');
+      std::getline (fields, dwellField, ':');
+      std::getline (fields, powerField, ':');
+      if (std::getline (fields, extra, ':'))
+        {
+          NS_LOG_ERROR ("SweepJammer:Too many fields in hop \"" << token << "\"");
+          return false;
+        }
+
+      Hop hop;
+      char *end;
+      unsigned long number = strtoul (channel.c_str (), &end, 10);
+      if (channel.empty () || !isdigit (channel[0]) || *end != '\0' ||
+          number == 0 || number > 65535)
+        {
+          NS_LOG_ERROR ("SweepJammer:Bad channel in hop \"" << token << "\"");
+          return false;
+        }
+      hop.channel = number;
+
+      hop.dwell = dwell;
+      if (!dwellField.empty ())
+        {
+          // Time aborts on an unknown unit, check it first
+          const char *begin = dwellField.c_str ();
+          double value = strtod (begin, &end);
+          bool known = end != begin && value > 0 &&
+            strspn (begin, "+-0123456789.eE") == size_t (end - begin);
+          if (known)
+            {
+              known = false;
+              for (const char *unit : units)
+                {
+                  known = known || std::string (end) == unit;
+                }
+            }
+          if (!known)
+            {
+              NS_LOG_ERROR ("SweepJammer:Bad dwell time in hop \"" << token << "\"");
+              return false;
+            }
+          hop.dwell = Time (dwellField);
+        }
+
+      hop.power = power;
+      if (!powerField.empty ())
+        {
+          hop.power = strtod (powerField.c_str (), &end);
+          if (end == powerField.c_str () || *end != '\0' || !(hop.power >= 0))
+            {
+              NS_LOG_ERROR ("SweepJammer:Bad power in hop \"" << token << "\"");
+              return false;
+            }
+        }
+      hops.push_back (hop);
+    }
+  return true;
+}
+
+Time
+SweepJammer::GetPeriod (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_period;
+}
+
+uint32_t
+SweepJammer::GetHopIndexAt (Time time) const
+{
+  NS_LOG_FUNCTION (this << time);
+  NS_ASSERT (!m_hops.empty ());
+  Time offset = GetOffsetAt (time);
+  // last hop starting at or before the offset, m_hopStart[0] is always 0
+  return std::upper_bound (m_hopStart.begin (), m_hopStart.end (), offset) -
+         m_hopStart.begin () - 1;
+}
+
+uint16_t
+SweepJammer::GetChannelAt (Time time) const
+{
+  NS_LOG_FUNCTION (this << time);
+  if (!IsJammerOn () || m_hops.empty ())
+    {
+      return 0;
+    }
+  return m_hops[GetHopIndexAt (time)].channel;
+}
+
+bool
+SweepJammer::IsJammingAt (uint16_t channel, Time time) const
+{
+  NS_LOG_FUNCTION (this << channel << time);
+  if (!IsJammerOn () || m_hops.empty ())
+    {
+      return false;
+    }
+  uint32_t index = GetHopIndexAt (time);
+  const Hop &hop = m_hops[index];
+  return hop.channel == channel && hop.power > 0 &&
+         GetOffsetAt (time) - m_hopStart[index] >= m_hopSettle[index];
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+SweepJammer::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_jammingEvent.Cancel ();
+  m_switchEvent.Cancel ();
+}
+
+void
+SweepJammer::DoStopJammer (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_jammingEvent.Cancel ();
+  m_switchEvent.Cancel ();
+}
+
+void
+SweepJammer::DoJamming (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_utility != NULL);
+
+  if (!IsJammerOn ()) // check if jammer is on
+    {
+      NS_LOG_DEBUG ("SweepJammer:At Node #" << GetId () << ", Jammer is OFF!");
+      return;
+    }
+
+  CompileSchedule ();
+  m_jammingEvent.Cancel ();
+  m_switchEvent.Cancel ();
+
+  m_startTime = Simulator::Now ();
+  m_hopIndex = 0;
+  Time settle = Seconds (0.0);
+  if (m_utility->GetPhyLayerInfo ().currentChannel != m_hops[0].channel)
+    {
+      m_utility->SwitchChannel (m_hops[0].channel);
+      settle = m_utility->GetPhyLayerInfo ().channelSwitchDelay;
+    }
+
+  NS_LOG_DEBUG ("SweepJammer:At Node #" << GetId () << ", Starting sweep of " <<
+                m_hops.size () << " hops, period = " << m_period.GetSeconds () <<
+                "s, At " << Simulator::Now ().GetSeconds () << "s");
+
+  m_jammingEvent = Simulator::Schedule (settle, &SweepJammer::JamHop, this);
+}
+
+bool
+SweepJammer::DoStartRxHandler (Ptr<Packet> packet, double startRss)
+{
+  NS_LOG_FUNCTION (this << packet << startRss);
+  return false;
+}
+
+bool
+SweepJammer::DoEndRxHandler (Ptr<Packet> packet, double averageRss)
+{
+  NS_LOG_FUNCTION (this << packet);
+  NS_LOG_DEBUG ("SweepJammer:At Node #" << GetId () <<
+                ", Ignoring incoming packet!");
+  return false;
+}
+
+void
+SweepJammer::DoEndTxHandler (Ptr<Packet> packet, double txPower)
+{
+  NS_LOG_FUNCTION (this << packet << txPower);
+  NS_LOG_DEBUG ("SweepJammer:At Node #" << GetId () <<
+                ", Sent jamming burst with power = " << txPower);
+  // the burst fills its hop, m_hopIndex already points to the next one
+  SwitchToNextHop ();
+}
+
+void
+SweepJammer::CompileSchedule (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_utility != NULL);
+
+  m_hops = m_addedHops;
+  if (m_hops.empty () &&
+      !ParseSchedule (m_schedule, m_dwellTime, m_txPower, m_hops))
+    {
+      NS_FATAL_ERROR ("SweepJammer:At Node #" << GetId () <<
+                      ", Error! Malformed hop schedule \"" << m_schedule << "\".");
+    }
+  if (m_hops.empty ())
+    {
+      NS_FATAL_ERROR ("SweepJammer:At Node #" << GetId () <<
+                      ", Error! Empty hop schedule.");
+    }
+
+  WirelessModuleUtility::PhyLayerInfo info = m_utility->GetPhyLayerInfo ();
+  m_hopStart.resize (m_hops.size ());
+  m_hopSettle.resize (m_hops.size ());
+  m_period = Seconds (0.0);
+  for (uint32_t i = 0; i < m_hops.size (); i++)
+    {
+      const Hop &hop = m_hops[i];
+      if (hop.channel == 0 || hop.channel > info.numOfChannels ||
+          !hop.dwell.IsStrictlyPositive () || hop.power < 0)
+        {
+          NS_FATAL_ERROR ("SweepJammer:At Node #" << GetId () <<
+                          ", Error! Invalid hop " << i << " on channel " <<
+                          hop.channel << " for " << hop.dwell << " at " <<
+                          hop.power << " W.");
+        }
+      // hops entered from another channel lose the switch delay
+      const Hop &previous = m_hops[(i + m_hops.size () - 1) % m_hops.size ()];
+      m_hopSettle[i] = previous.channel != hop.channel ?
+        info.channelSwitchDelay : Seconds (0.0);
+      if (hop.power > 0 && hop.dwell <= m_hopSettle[i])
+        {
+          NS_FATAL_ERROR ("SweepJammer:At Node #" << GetId () <<
+                          ", Error! Dwell time of hop " << i <<
+                          " does not cover the channel switch delay.");
+        }
+      m_hopStart[i] = m_period;
+      m_period += hop.dwell;
+    }
+}
+
+Time
+SweepJammer::GetOffsetAt (Time time) const
+{
+  int64_t elapsed = (time - m_startTime).GetTimeStep ();
+  if (elapsed <= 0)
+    {
+      return Seconds (0.0);
+    }
+  return TimeStep (elapsed % m_period.GetTimeStep ());
+}
+
+void
+SweepJammer::JamHop (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_utility != NULL);
+
+  Time now = Simulator::Now ();
+  uint32_t index = GetHopIndexAt (now);
+  const Hop &hop = m_hops[index];
+  Time hopEnd = now - GetOffsetAt (now) + m_hopStart[index] + hop.dwell;
+
+  bool sent = false;
+  if (hop.power > 0 && hopEnd > now)
+    {
+      NS_LOG_DEBUG ("SweepJammer:At Node #" << GetId () <<
+                    ", Jamming channel " << hop.channel << " with TX power = " <<
+                    hop.power << " W until " << hopEnd.GetSeconds () << "s");
+      double actualPower = m_utility->SendJammingSignal (hop.power, hopEnd - now);
+      sent = actualPower != 0.0;
+      if (!sent)
+        {
+          NS_LOG_ERROR ("SweepJammer:At Node #" << GetId () <<
+                        ", Failed to send jamming signal!");
+        }
+    }
+
+  // single event per hop: next burst starts once the channel has settled
+  m_hopIndex = (index + 1) % m_hops.size ();
+  m_jammingEvent = Simulator::Schedule (hopEnd + m_hopSettle[m_hopIndex] - now,
+                                        &SweepJammer::JamHop, this);
+  if (!sent)
+    {
+      // no end of TX to switch on
+      m_switchEvent = Simulator::Schedule (hopEnd - now,
+                                           &SweepJammer::SwitchToNextHop, this);
+    }
+}
+
+void
+SweepJammer::SwitchToNextHop (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint16_t currentChannel = m_utility->GetPhyLayerInfo ().currentChannel;
+  uint16_t nextChannel = m_hops[m_hopIndex].channel;
+  if (nextChannel != currentChannel)
+    {
+      NS_LOG_DEBUG ("SweepJammer:At Node #" << GetId () <<
+                    ", Switching from channel " << currentChannel << " >-> " <<
+                    nextChannel << ", At " << Simulator::Now ().GetSeconds () << "s");
+      m_utility->SwitchChannel (nextChannel);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,231 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SWEEP_JAMMER_H
+#define SWEEP_JAMMER_H
+
+#include "jammer.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Sweep Jammer.
+ *
+ * Jams a fixed sequence of channels, each for its own dwell time and with its
+ * own TX power, and repeats the sequence until stopped. The hop schedule is
+ * compiled once when the jammer starts, after which the hop active at any
+ * time is computed from the time alone. On air the jammer needs a single
+ * event per hop: the burst of each hop fills its dwell time (less the channel
+ * switch delay) and the channel is switched at the end of the burst.
+ *
+ * The schedule is either given as a string through the SweepJammerSchedule
+ * attribute, "channel[:dwell[:power]]" per hop separated by spaces, e.g.
+ * "1:10ms:0.001 6:20ms 11", or built with AddHop. Missing dwell times and
+ * powers default to SweepJammerDwellTime and SweepJammerTxPower.
+ */
+class SweepJammer : public Jammer
+{
+public:
+  /**
+   * One hop of the sweep.
+   */
+  struct Hop
+  {
+    uint16_t channel; // channel to jam
+    Time dwell;       // time spent on the channel
+    double power;     // TX power in Watts, 0 to listen only
+  };
+
+  static TypeId GetTypeId (void);
+  SweepJammer ();
+  virtual ~SweepJammer ();
+
+  /**
+   * \brief Sets pointer to WirelessModuleUtility installed on node..
+   *
+   * \param utility Pointer to WirelessModuleUtility.
+   */
+  virtual void SetUtility (Ptr<WirelessModuleUtility> utility);
+
+  /**
+   * \brief Sets pointer to energy source.
+   *
+   * \param energySrcPtr Pointer to EnergySource installed on node.
+   *
+   * This function is called by JammerHelper.
+   */
+  virtual void SetEnergySource (Ptr<EnergySource> source);
+
+  // setter & getters of attributes
+  void SetTxPower (double power);
+  double GetTxPower (void) const;
+  void SetDwellTime (Time dwell);
+  Time GetDwellTime (void) const;
+  void SetSchedule (std::string schedule);
+  std::string GetSchedule (void) const;
+
+  /**
+   * \brief Appends a hop to the schedule.
+   *
+   * \param channel Channel to jam.
+   * \param dwell Time spent on the channel.
+   * \param power TX power in Watts, 0 to stay silent on the channel.
+   *
+   * Hops added this way replace the SweepJammerSchedule attribute. The
+   * schedule is recompiled when the jammer is next started.
+   */
+  void AddHop (uint16_t channel, Time dwell, double power);
+
+  /**
+   * Removes all hops added with AddHop.
+   */
+  void ClearHops (void);
+
+  /**
+   * \brief Parses a hop schedule in the SweepJammerSchedule format.
+   *
+   * \param schedule "channel[:dwell[:power]]" per hop separated by spaces.
+   * \param dwell Dwell time of hops that give none.
+   * \param power TX power of hops that give none.
+   * \param hops Receives the parsed hops.
+   * \returns False if an entry is malformed, hops then ends before it.
+   *
+   * An entry is malformed if its channel is not a number from 1 to 65535,
+   * its dwell time not a positive time with an ns-3 unit, its power not a
+   * non-negative number or if it has more than three fields. Channels are
+   * checked against the PHY when the schedule is compiled.
+   */
+  static bool ParseSchedule (std::string schedule, Time dwell, double power,
+                             std::vector<Hop> &hops);
+
+  /**
+   * \returns Duration of one pass through the schedule.
+   */
+  Time GetPeriod (void) const;
+
+  /**
+   * \param time Simulation time.
+   * \returns Index of the hop active at the given time.
+   *
+   * Computed from the time alone, no event is needed. Only valid while the
+   * jammer has a compiled schedule, i.e. after it was started.
+   */
+  uint32_t GetHopIndexAt (Time time) const;
+
+  /**
+   * \param time Simulation time.
+   * \returns Channel jammed at the given time, 0 if the jammer is off.
+   */
+  uint16_t GetChannelAt (Time time) const;
+
+  /**
+   * \param channel Channel number.
+   * \param time Simulation time.
+   * \returns True if the jammer is transmitting on the channel at that time.
+   *
+   * Excludes the channel switch delay at the start of a hop and hops with
+   * zero power.
+   */
+  bool IsJammingAt (uint16_t channel, Time time) const;
+
+private:
+  void DoDispose (void);
+
+  /**
+   * Stops jammer.
+   */
+  virtual void DoStopJammer (void);
+
+  /**
+   * Compiles the schedule and jams the hop active now.
+   */
+  virtual void DoJamming (void);
+
+  /**
+   * \brief Handles start RX event.
+   *
+   * \param packet Pointer to incoming packet.
+   * \param startRss Start RSS of packet.
+   * \return False. Sweep jammer will *always* ignore incoming packets.
+   */
+  virtual bool DoStartRxHandler (Ptr<Packet> packet, double startRss);
+
+  /**
+   * \brief Handles end RX event (incoming packet).
+   *
+   * \param packet Pointer to incoming packet.
+   * \param averageRss Average RSS of packet.
+   * \returns False. Sweep jammer will *always* ignore incoming packets.
+   */
+  virtual bool DoEndRxHandler (Ptr<Packet> packet, double averageRss);
+
+  /**
+   * \brief Notifies jammer of end of sending jamming signal
+   *
+   * \param packet Pointer to dummy packet that was sent.
+   * \param txPower Transmit power of packet.
+   *
+   * For sweep jammer, it switches to the channel of the next hop.
+   */
+  virtual void DoEndTxHandler (Ptr<Packet> packet, double txPower);
+
+  /**
+   * Builds the hop list, start offsets and switch delays of the schedule.
+   */
+  void CompileSchedule (void);
+
+  /**
+   * \param time Simulation time, not before the jammer started.
+   * \returns Time since the start of the current pass through the schedule.
+   */
+  Time GetOffsetAt (Time time) const;
+
+  /**
+   * Sends the burst of the current hop and schedules the next one.
+   */
+  void JamHop (void);
+
+  /**
+   * Switches the PHY to the channel of the next hop.
+   */
+  void SwitchToNextHop (void);
+
+private:
+  Ptr<WirelessModuleUtility> m_utility; // pointer to utility
+  Ptr<EnergySource> m_source;           // pointer to energy source
+  double m_txPower;                     // default TX power
+  Time m_dwellTime;                     // default dwell time
+  std::string m_schedule;               // schedule attribute
+  std::vector<Hop> m_addedHops;         // hops added with AddHop
+
+  std::vector<Hop> m_hops;              // compiled schedule
+  std::vector<Time> m_hopStart;         // start of each hop within a pass
+  std::vector<Time> m_hopSettle;        // switch delay at the start of each hop
+  Time m_period;                        // duration of one pass
+  Time m_startTime;                     // start of the first pass
+  uint32_t m_hopIndex;                  // hop of the pending burst
+  EventId m_jammingEvent;               // next burst
+  EventId m_switchEvent;                // channel switch after a silent hop
+
+};
+
+} // namespace ns3
+
+#endif /* SWEEP_JAMMER_H */
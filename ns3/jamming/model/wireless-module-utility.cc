@@ -25,6 +25,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/enum.h"
 #include "ns3/pointer.h"
@@ -32,6 +33,8 @@
 #include "ns3/node.h"
 #include "ns3/trace-source-accessor.h"
 #include <math.h>
+#include <algorithm>
+#include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("WirelessModuleUtility");
 
@@ -57,12 +60,37 @@ WirelessModuleUtility::GetTypeId (void)
                    MakeUintegerAccessor (&WirelessModuleUtility::SetPdrWindowSize,
                                          &WirelessModuleUtility::GetPdrWindowSize),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("PdrWindowTime",
+                   "Time window for the TimeWindowPdr measurement, 0 to disable it.",
+                   TimeValue (Seconds (0)),       // disabled by default
+                   MakeTimeAccessor (&WirelessModuleUtility::SetPdrWindowTime,
+                                     &WirelessModuleUtility::GetPdrWindowTime),
+                   MakeTimeChecker ())
     .AddAttribute ("RssUpdateInterval",
                    "Update interval of RSS values.",
                    TimeValue (Seconds (0.5)),   // default to 0.5 second
                    MakeTimeAccessor (&WirelessModuleUtility::SetRssUpdateInterval,
                                      &WirelessModuleUtility::GetRssUpdateInterval),
                    MakeTimeChecker ())
+    .AddAttribute ("PeriodicRss",
+                   "Sample RSS every RssUpdateInterval, for nodes whose Rss trace is connected. "
+                   "Otherwise RSS is measured on receptions, at the start and end of signals "
+                   "the PHY does not receive, and when read.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WirelessModuleUtility::SetPeriodicRss,
+                                        &WirelessModuleUtility::GetPeriodicRss),
+                   MakeBooleanChecker ())
+    .AddAttribute ("StatisticsAlpha",
+                   "Weight of the newest sample in the EWMA of the streaming statistics, in (0, 1].",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&WirelessModuleUtility::SetStatisticsAlpha,
+                                       &WirelessModuleUtility::GetStatisticsAlpha),
+                   MakeDoubleChecker<double> (std::numeric_limits<double>::min (), 1.0))
+    .AddAttribute ("BusyThreshold",
+                   "Node RSS (dBm) at or above which the channel counts as busy.",
+                   DoubleValue (-82.0),          // 802.11 preamble detection level
+                   MakeDoubleAccessor (&WirelessModuleUtility::m_busyThresholdDbm),
+                   MakeDoubleChecker<double> ())
     .AddTraceSource ("TotalBytesRx",
                      "Total bytes received at current node.",
                      MakeTraceSourceAccessor (&WirelessModuleUtility::m_totalBytesRx),
@@ -83,6 +111,10 @@ WirelessModuleUtility::GetTypeId (void)
                      "Packet Delivery Rate at current node.",
                      MakeTraceSourceAccessor (&WirelessModuleUtility::m_Pdr),
                      "ns3::Packet::TracedCallback")
+    .AddTraceSource ("TimeWindowPdr",
+                     "Packet Delivery Rate over the last PdrWindowTime at current node.",
+                     MakeTraceSourceAccessor (&WirelessModuleUtility::m_timeWindowPdr),
+                     "ns3::Packet::TracedCallback")
     .AddTraceSource ("Rss",
                      "Received Signal Strength at current node.",
                      MakeTraceSourceAccessor (&WirelessModuleUtility::m_nodeRssW),
@@ -91,6 +123,18 @@ WirelessModuleUtility::GetTypeId (void)
                      "Received Signal Strength per packet at current node.",
                      MakeTraceSourceAccessor (&WirelessModuleUtility::m_avgPktRssW),
                      "ns3::Packet::TracedCallback")
+    .AddTraceSource ("PacketRssEwma",
+                     "EWMA of the average RSS of received packets, in dBm.",
+                     MakeTraceSourceAccessor (&WirelessModuleUtility::m_packetRssEwma),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("InterArrivalEwma",
+                     "EWMA of the time between packet receptions, in seconds.",
+                     MakeTraceSourceAccessor (&WirelessModuleUtility::m_interArrivalEwma),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("BusyFractionEwma",
+                     "EWMA of the busy fraction of each throughput update interval.",
+                     MakeTraceSourceAccessor (&WirelessModuleUtility::m_busyFractionEwma),
+                     "ns3::Packet::TracedCallback")
     ;
   return tid;
 }
@@ -102,16 +146,32 @@ WirelessModuleUtility::WirelessModuleUtility (void)
      m_previousTotalBytesTx (0),
      m_throughputRx (0),
      m_throughputTx (0),
+     m_resolvedTypeIds (0),
      m_Pdr (0),
      m_numOfPktsRecvd (0),
      m_pdrArrayCurIndex (0),
+     m_validInWindow (0),
+     m_validInTime (0),
+     m_timeWindowPdr (0),
      m_nodeRssW (0),
+     m_periodicRss (false),
+     m_packetRssStat (-110, 0, 110),
+     m_interArrivalStat (1e-6, 100, 80, true),
+     m_busyFractionStat (0, 1, 100),
+     m_lastRxTime (Seconds (-1)),
+     m_channelBusy (false),
+     m_packetRssEwma (0),
+     m_interArrivalEwma (0),
+     m_busyFractionEwma (0),
      m_totalPkts (0),
-     m_validPkts (0)
+     m_validPkts (0),
+     m_receivedPkts (0),
+     m_receivedValidPkts (0)
 {
   m_pktStatusRecord.clear ();
   m_rssMeasurementCallback.Nullify ();
   m_sendPacketCallback.Nullify ();
+  m_sendSignalCallback.Nullify ();
   m_startRxCallback.Nullify ();
   m_startTxCallback.Nullify ();
   m_endRxCallback.Nullify ();
@@ -157,7 +217,10 @@ WirelessModuleUtility::SetPdrWindowSize (uint32_t pdrWindowSize)
   m_pdrWindowSize = pdrWindowSize;
   // allocate packet status record list upon changing PDR window size
   m_pktStatusRecord.clear ();
-  m_pktStatusRecord.assign (m_pdrWindowSize, false);
+  m_pktStatusRecord.assign ((m_pdrWindowSize + 63) / 64, 0);
+  m_validInWindow = 0;
+  m_numOfPktsRecvd = 0;
+  m_pdrArrayCurIndex = 0;
 }
 
 uint32_t
@@ -167,6 +230,25 @@ WirelessModuleUtility::GetPdrWindowSize (void) const
   return m_pdrWindowSize;
 }
 
+void
+WirelessModuleUtility::SetPdrWindowTime (Time pdrWindowTime)
+{
+  NS_LOG_FUNCTION (this << pdrWindowTime);
+  NS_ASSERT (pdrWindowTime.GetSeconds () >= 0);
+  m_pdrWindowTime = pdrWindowTime;
+  m_pdrTimeRecord.clear ();
+  m_validInTime = 0;
+  m_expireTimeWindowEvent.Cancel ();
+  m_timeWindowPdr = 0;
+}
+
+Time
+WirelessModuleUtility::GetPdrWindowTime (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_pdrWindowTime;
+}
+
 void
 WirelessModuleUtility::SetRssUpdateInterval (Time updateInterval)
 {
@@ -181,6 +263,42 @@ WirelessModuleUtility::GetRssUpdateInterval (void) const
   return m_rssUpdateInterval;
 }
 
+void
+WirelessModuleUtility::SetPeriodicRss (bool periodicRss)
+{
+  NS_LOG_FUNCTION (this << periodicRss);
+  m_periodicRss = periodicRss;
+  m_updateRssEvent.Cancel ();
+  if (m_periodicRss && !Simulator::IsFinished ())
+    {
+      m_updateRssEvent = Simulator::ScheduleNow (&WirelessModuleUtility::UpdateRss,
+                                                 this);
+    }
+}
+
+bool
+WirelessModuleUtility::GetPeriodicRss (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_periodicRss;
+}
+
+void
+WirelessModuleUtility::SetStatisticsAlpha (double alpha)
+{
+  NS_LOG_FUNCTION (this << alpha);
+  m_packetRssStat.SetAlpha (alpha);
+  m_interArrivalStat.SetAlpha (alpha);
+  m_busyFractionStat.SetAlpha (alpha);
+}
+
+double
+WirelessModuleUtility::GetStatisticsAlpha (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_packetRssStat.GetAlpha ();
+}
+
 void
 WirelessModuleUtility::SetRssMeasurementCallback (UtilityRssCallback RssCallback)
 {
@@ -193,6 +311,7 @@ WirelessModuleUtility::SetInclusionList (std::vector<std::string> list)
 {
   NS_LOG_FUNCTION (this);
   m_headerInclusionList = list;
+  ResolveHeaderLists ();
 }
 
 void
@@ -200,6 +319,7 @@ WirelessModuleUtility::SetExclusionList (std::vector<std::string> list)
 {
   NS_LOG_FUNCTION (this);
   m_headerExclusionList = list;
+  ResolveHeaderLists ();
 }
 
 void
@@ -209,6 +329,13 @@ WirelessModuleUtility::SetSendPacketCallback (UtilitySendPacketCallback sendPack
   m_sendPacketCallback = sendPacketCallback;
 }
 
+void
+WirelessModuleUtility::SetSendSignalCallback (UtilitySendSignalCallback sendSignalCallback)
+{
+  NS_LOG_FUNCTION (this);
+  m_sendSignalCallback = sendSignalCallback;
+}
+
 void
 WirelessModuleUtility::SetChannelSwitchCallback (UtilityChannelSwitchCallback channelSwitchCallback)
 {
@@ -265,6 +392,20 @@ WirelessModuleUtility::GetTotalPkts ()
   return m_totalPkts;
 }
 
+uint64_t
+WirelessModuleUtility::GetReceivedPkts (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_receivedPkts;
+}
+
+uint64_t
+WirelessModuleUtility::GetReceivedValidPkts (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_receivedValidPkts;
+}
+
 
 WirelessModuleUtility::PhyLayerInfo
 WirelessModuleUtility::GetPhyLayerInfo (void) const
@@ -304,6 +445,7 @@ WirelessModuleUtility::EndRxHandler (Ptr<Packet> packet,
   UpdateRss();
   
   AnalyzeAndRecordIncomingPacket (packet, isSuccessfullyReceived);
+  UpdateRxStatistics (averageRssW);
 
   m_avgPktRssW = averageRssW;
 
@@ -359,6 +501,13 @@ WirelessModuleUtility::EndTxHandler (Ptr<const Packet> packet, double txPower)
     }
 }
 
+void
+WirelessModuleUtility::SignalChangeHandler (void)
+{
+  NS_LOG_FUNCTION (this);
+  MeasureRss ();
+}
+
 uint64_t
 WirelessModuleUtility::GetTotalBytesRx (void) const
 {
@@ -395,12 +544,63 @@ WirelessModuleUtility::GetPdr (void) const
 }
 
 double
-WirelessModuleUtility::GetRss (void) const
+WirelessModuleUtility::GetTimeWindowPdr (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_timeWindowPdr;
+}
+
+uint64_t
+WirelessModuleUtility::GetFootprint (void) const
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t bytes = sizeof (*this);
+  bytes += m_pktStatusRecord.capacity () * sizeof (uint64_t);
+  bytes += m_pdrTimeRecord.size () * sizeof (std::pair<Time, bool>);
+  bytes += (m_inclusionUids.capacity () + m_exclusionUids.capacity ()) * sizeof (uint16_t);
+  for (uint32_t i = 0; i < m_headerInclusionList.size (); i++)
+    {
+      bytes += sizeof (std::string) + m_headerInclusionList[i].capacity ();
+    }
+  for (uint32_t i = 0; i < m_headerExclusionList.size (); i++)
+    {
+      bytes += sizeof (std::string) + m_headerExclusionList[i].capacity ();
+    }
+  bytes += m_packetRssStat.GetFootprint ();
+  bytes += m_interArrivalStat.GetFootprint ();
+  bytes += m_busyFractionStat.GetFootprint ();
+  return bytes;
+}
+
+double
+WirelessModuleUtility::GetRss (void)
 {
   NS_LOG_FUNCTION (this);
+  MeasureRss ();
   return m_nodeRssW;
 }
 
+const StreamingStatistic &
+WirelessModuleUtility::GetPacketRssStatistic (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_packetRssStat;
+}
+
+const StreamingStatistic &
+WirelessModuleUtility::GetInterArrivalStatistic (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_interArrivalStat;
+}
+
+const StreamingStatistic &
+WirelessModuleUtility::GetBusyFractionStatistic (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_busyFractionStat;
+}
+
 /*
  * Private functions start here!
  */
@@ -420,6 +620,7 @@ WirelessModuleUtility::DoDispose (void)
   // show total bytes at end of simulation
   NS_LOG_DEBUG ("WirelessModuleUtility:Total bytes RX = " << m_totalBytesRx);
   NS_LOG_DEBUG ("WirelessModuleUtility:Total bytes TX = " << m_totalBytesTx);
+  m_expireTimeWindowEvent.Cancel ();
 }
 
 void
@@ -427,13 +628,10 @@ WirelessModuleUtility::AnalyzeAndRecordIncomingPacket (const Ptr<Packet> packet,
     bool isSuccessfullyReceived)
 {
   NS_LOG_FUNCTION (this << packet << isSuccessfullyReceived);
-  NS_LOG_FUNCTION (packet->GetSize());
-  NS_LOG_FUNCTION(FindHeaderInInclusionList(packet));
-  NS_LOG_FUNCTION(FindHeaderInExclusionList(packet));
 
   if (isSuccessfullyReceived)
     {
-      if (FindHeaderInInclusionList (packet) && !FindHeaderInExclusionList (packet))
+      if (IsPacketRecorded (packet))
         {
           m_totalBytesRx += packet->GetSize ();
         }
@@ -451,7 +649,7 @@ WirelessModuleUtility::AnalyzeAndRecordOutgoingPacket (Ptr<const Packet> packet)
   NS_LOG_FUNCTION (this << packet);
   NS_LOG_INFO("tes avant");
 
-  /*if (FindHeaderInInclusionList (packet) && !FindHeaderInExclusionList (packet))
+  /*if (IsPacketRecorded (packet))
     {*/
       NS_LOG_INFO("tes dans fonction");
       m_totalBytesTx += packet->GetSize ();
@@ -474,6 +672,13 @@ void WirelessModuleUtility::UpdateThroughput (void)
   m_throughputTx = (double)(txChange * 8) / throughputUpdateIntervalS;
   m_throughputRx = (double)(rxChange * 8) / throughputUpdateIntervalS;
 
+  // busy fraction over the same interval, up to a fresh RSS reading
+  MeasureRss ();
+  double busyFraction = m_busyTime.GetSeconds () / throughputUpdateIntervalS;
+  m_busyFractionStat.Add (std::min (busyFraction, 1.0));
+  m_busyFractionEwma = m_busyFractionStat.GetEwma ();
+  m_busyTime = Seconds (0);
+
   // step to next update window
   m_previousTotalBytesTx = m_totalBytesTx;
   m_previousTotalBytesRx = m_totalBytesRx;
@@ -484,117 +689,88 @@ void WirelessModuleUtility::UpdateThroughput (void)
                                                  this);
 }
 
-uint32_t
-WirelessModuleUtility::FindHeader (Ptr<const Packet> packet,
-                                   std::string headerName) const
-{
-  NS_LOG_FUNCTION (this << packet);
-  Packet copy = *packet;  // make a copy of the header
-  NS_LOG_DEBUG ("WirelessModuleUtility:Packet has the following headers/trailers:" <<
-                "\n----------\n" << copy << "\n----------");
-
-  // iterate through all items in the header
-  PacketMetadata::ItemIterator pktItemIterator = copy.BeginItem ();
-  while (pktItemIterator.HasNext ())
-    {
-      PacketMetadata::Item item = pktItemIterator.Next ();
-      if (item.isFragment)
-        {
-          switch (item.type)
-            {
-            case PacketMetadata::Item::PAYLOAD:
-              break;
-            case PacketMetadata::Item::HEADER:
-            case PacketMetadata::Item::TRAILER:
-              std::string itemName = item.tid.GetName ();
-              uint32_t size = item.currentSize; // obtain size of header/trailer
-              // check if we found header string
-              if (headerName.compare (itemName) == 0)
-                {
-                  NS_LOG_DEBUG ("WirelessModuleUtility:" << itemName <<
-                                " Found!" << " Size = " << size << " bytes");
-                  return size;
-                }
-              break;
-            }
-          NS_LOG_DEBUG ("WirelessModuleUtility:" << " Fragment [" <<
-                        item.currentTrimedFromStart <<":" <<
-                        (item.currentTrimedFromStart + item.currentSize) << "]");
-        } // end if
-      else
-        {
-          switch (item.type)
-            {
-            case PacketMetadata::Item::PAYLOAD:
-              NS_LOG_DEBUG ("WirelessModuleUtility:" << "Payload (size=" <<
-                            item.currentSize << ")");
-              break;
-            case PacketMetadata::Item::HEADER:
-            case PacketMetadata::Item::TRAILER:
-              std::string itemName = item.tid.GetName ();
-              uint32_t size = item.currentSize; // obtain size of header/trailer
-              // check if we found header string
-              if (headerName.compare (itemName) == 0)
-                {
-                  NS_LOG_DEBUG ("WirelessModuleUtility:" << itemName <<
-                                " Found!" << " Size = " << size << " bytes");
-                  return size;  // header/trailer found
-                }
-              // skip checking of header/trailer contents
-              break;
-            }
-        } // end else
-    } // end while
-  return 0; // return 0 if not found
-}
-
 bool
-WirelessModuleUtility::FindHeaderInInclusionList (Ptr<const Packet> packet)
+WirelessModuleUtility::IsPacketRecorded (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet);
 
   /*
-   * Return true if list is empty. The inclusion list is default to be empty,
-   * that is, we will include packets with any header/trailer.
+   * The inclusion list is default to be empty, that is, we will include
+   * packets with any header/trailer. With both lists empty there is nothing
+   * to look for in the packet.
    */
-  if (m_headerInclusionList.empty ())
+  bool included = m_headerInclusionList.empty ();
+  if (included && m_headerExclusionList.empty ())
     {
-      NS_LOG_FUNCTION ("findheader");
-
       return true;
     }
 
-  // iterate through the header/trailer inclusion list
-  std::vector<std::string>::iterator listItr = m_headerInclusionList.begin ();
-  while (listItr != m_headerInclusionList.end ())
+  // pick up headers/trailers whose TypeId was registered after the lists
+  if (m_resolvedTypeIds != 0 && m_resolvedTypeIds != TypeId::GetRegisteredN ())
     {
-      if (FindHeader (packet, *listItr) != 0)
+      ResolveHeaderLists ();
+    }
+
+  NS_LOG_DEBUG ("WirelessModuleUtility:Packet has the following headers/trailers:" <<
+                "\n----------\n" << *packet << "\n----------");
+
+  // iterate through all headers/trailers of the packet, no copy needed
+  PacketMetadata::ItemIterator pktItemIterator = packet->BeginItem ();
+  while (pktItemIterator.HasNext ())
+    {
+      PacketMetadata::Item item = pktItemIterator.Next ();
+      // empty headers/trailers were never counted as found
+      if (item.type == PacketMetadata::Item::PAYLOAD || item.currentSize == 0)
         {
-          NS_LOG_FUNCTION ("findheader2");
-          return true;
+          continue;
+        }
+      uint16_t uid = item.tid.GetUid ();
+      if (std::binary_search (m_exclusionUids.begin (), m_exclusionUids.end (), uid))
+        {
+          NS_LOG_DEBUG ("WirelessModuleUtility:" << item.tid.GetName () << " excluded");
+          return false;
+        }
+      if (!included && std::binary_search (m_inclusionUids.begin (), m_inclusionUids.end (), uid))
+        {
+          NS_LOG_DEBUG ("WirelessModuleUtility:" << item.tid.GetName () << " included");
+          included = true;
+          if (m_exclusionUids.empty ())
+            {
+              return true;
+            }
         }
-      listItr++;
     }
-    NS_LOG_FUNCTION ("findheader3");
-  return false;
+  return included;
 }
 
-bool
-WirelessModuleUtility::FindHeaderInExclusionList (Ptr<const Packet> packet)
+void
+WirelessModuleUtility::ResolveHeaderLists (void)
 {
-  NS_LOG_FUNCTION (this << packet);
-
-  // iterate through the header/trailer exclusion list
-  std::vector<std::string>::iterator listItr = m_headerExclusionList.begin ();
-  while (listItr != m_headerExclusionList.end ())
+  NS_LOG_FUNCTION (this);
+  bool complete = true;
+  std::vector<std::string> *lists[] = {&m_headerInclusionList, &m_headerExclusionList};
+  std::vector<uint16_t> *uids[] = {&m_inclusionUids, &m_exclusionUids};
+  for (uint32_t i = 0; i < 2; i++)
     {
-      if (FindHeader (packet, *listItr) != 0)
+      uids[i]->clear ();
+      std::vector<std::string>::const_iterator listItr = lists[i]->begin ();
+      for (; listItr != lists[i]->end (); listItr++)
         {
-          return true;
+          TypeId tid;
+          if (TypeId::LookupByNameFailSafe (*listItr, &tid))
+            {
+              uids[i]->push_back (tid.GetUid ());
+            }
+          else
+            {
+              NS_LOG_DEBUG ("WirelessModuleUtility:" << *listItr << " is not registered yet");
+              complete = false;
+            }
         }
-      listItr++;
+      std::sort (uids[i]->begin (), uids[i]->end ());
+      uids[i]->erase (std::unique (uids[i]->begin (), uids[i]->end ()), uids[i]->end ());
     }
-  return false;
+  m_resolvedTypeIds = complete ? 0 : TypeId::GetRegisteredN ();
 }
 
 void
@@ -607,7 +783,13 @@ WirelessModuleUtility::UpdatePdr (const bool isPacketValid)
   // create m_pktStatusRecord list ONLY if empty (initialization)
   if (m_pktStatusRecord.empty ())
     {
-      m_pktStatusRecord.assign (m_pdrWindowSize, false);
+      m_pktStatusRecord.assign ((m_pdrWindowSize + 63) / 64, 0);
+    }
+
+  m_receivedPkts++;
+  if (isPacketValid)
+    {
+      m_receivedValidPkts++;
     }
 
   // insert current packet status into PDR status list
@@ -616,7 +798,6 @@ WirelessModuleUtility::UpdatePdr (const bool isPacketValid)
   // calculate how many packets the PDR is to be calculated with.
   if (m_numOfPktsRecvd > m_pdrWindowSize)
     {
-      
       totalPkts = m_pdrWindowSize;
     }
   else
@@ -624,15 +805,8 @@ WirelessModuleUtility::UpdatePdr (const bool isPacketValid)
       totalPkts = m_numOfPktsRecvd;
     }
 
-  // Count the number of valid packets in the array
-  validPkts = 0;
-  for (uint32_t i = 0; i < totalPkts ; i++)
-    {
-      if (m_pktStatusRecord[i])
-        {
-          validPkts++;
-        }
-    }
+  // valid packets are counted as they enter and leave the window
+  validPkts = m_validInWindow;
   // calculate PDR
   m_Pdr = (double) validPkts / (double) totalPkts;
 
@@ -642,6 +816,11 @@ WirelessModuleUtility::UpdatePdr (const bool isPacketValid)
   
   m_totalPkts = totalPkts;
   m_validPkts = validPkts;
+
+  if (!m_pdrWindowTime.IsZero ())
+    {
+      UpdateTimeWindowPdr (isPacketValid);
+    }
 }
 
 
@@ -651,9 +830,24 @@ WirelessModuleUtility::InsertIntoPdrArray (bool newPacketStatus)
   NS_LOG_FUNCTION (this << newPacketStatus);
   /*
    * Insert the status of the latest packet at the current index of array and
-   * increment the current index to be ready for next insertion.
+   * increment the current index to be ready for next insertion. The status it
+   * overwrites is the packet leaving the window, so the count of valid packets
+   * only changes when the two differ.
    */
-  m_pktStatusRecord[m_pdrArrayCurIndex++] = newPacketStatus;
+  uint64_t &word = m_pktStatusRecord[m_pdrArrayCurIndex / 64];
+  uint64_t mask = (uint64_t) 1 << (m_pdrArrayCurIndex % 64);
+  bool oldPacketStatus = (word & mask) != 0;
+  if (newPacketStatus && !oldPacketStatus)
+    {
+      word |= mask;
+      m_validInWindow++;
+    }
+  else if (!newPacketStatus && oldPacketStatus)
+    {
+      word &= ~mask;
+      m_validInWindow--;
+    }
+  m_pdrArrayCurIndex++;
   m_numOfPktsRecvd++;
 
   // wrap around the array
@@ -663,6 +857,48 @@ WirelessModuleUtility::InsertIntoPdrArray (bool newPacketStatus)
     }
 }
 
+void
+WirelessModuleUtility::UpdateTimeWindowPdr (bool newPacketStatus)
+{
+  NS_LOG_FUNCTION (this << newPacketStatus);
+  m_pdrTimeRecord.push_back (std::make_pair (Simulator::Now (), newPacketStatus));
+  if (newPacketStatus)
+    {
+      m_validInTime++;
+    }
+  ExpireTimeWindow ();
+}
+
+void
+WirelessModuleUtility::ExpireTimeWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time oldest = Simulator::Now () - m_pdrWindowTime;
+  while (!m_pdrTimeRecord.empty () && m_pdrTimeRecord.front ().first <= oldest)
+    {
+      if (m_pdrTimeRecord.front ().second)
+        {
+          m_validInTime--;
+        }
+      m_pdrTimeRecord.pop_front ();
+    }
+
+  if (m_pdrTimeRecord.empty ())
+    {
+      m_timeWindowPdr = 0;
+      return;
+    }
+  m_timeWindowPdr = (double) m_validInTime / (double) m_pdrTimeRecord.size ();
+
+  // only expiry removes the oldest packet, a running event is still on time
+  if (!m_expireTimeWindowEvent.IsRunning ())
+    {
+      m_expireTimeWindowEvent = Simulator::Schedule (m_pdrTimeRecord.front ().first - oldest,
+                                                     &WirelessModuleUtility::ExpireTimeWindow,
+                                                     this);
+    }
+}
+
 void
 WirelessModuleUtility::UpdateRss (void)
 {
@@ -676,16 +912,64 @@ WirelessModuleUtility::UpdateRss (void)
       return;
     }
 
-  m_nodeRssW = m_rssMeasurementCallback (); // calculate & set RSS
+  MeasureRss ();
 
   NS_LOG_DEBUG ("WirelessModuleUtility:At time = " << Simulator::Now().GetSeconds () <<
                 " s" << ", Current RSS = " << m_nodeRssW << " W" << ", in dBm " <<
                 WToDbm (m_nodeRssW));
 
-  // schedule next update
-  m_updateRssEvent = Simulator::Schedule (m_rssUpdateInterval,
-                                          &WirelessModuleUtility::UpdateRss,
-                                          this);
+  // schedule next update, idle nodes are only measured when read
+  if (m_periodicRss)
+    {
+      m_updateRssEvent = Simulator::Schedule (m_rssUpdateInterval,
+                                              &WirelessModuleUtility::UpdateRss,
+                                              this);
+    }
+}
+
+void
+WirelessModuleUtility::MeasureRss (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_rssMeasurementCallback.IsNull ())
+    {
+      return;
+    }
+  m_nodeRssW = m_rssMeasurementCallback (); // calculate & set RSS
+  AccountBusyTime (m_nodeRssW);
+}
+
+void
+WirelessModuleUtility::AccountBusyTime (double rssW)
+{
+  NS_LOG_FUNCTION (this << rssW);
+  Time now = Simulator::Now ();
+  if (m_channelBusy)
+    {
+      m_busyTime += now - m_lastRssTime;
+    }
+  // -1 means no valid RSS reading, count it as idle
+  m_channelBusy = rssW > 0 && WToDbm (rssW) >= m_busyThresholdDbm;
+  m_lastRssTime = now;
+}
+
+void
+WirelessModuleUtility::UpdateRxStatistics (double averageRssW)
+{
+  NS_LOG_FUNCTION (this << averageRssW);
+  if (averageRssW > 0)
+    {
+      m_packetRssStat.Add (WToDbm (averageRssW));
+      m_packetRssEwma = m_packetRssStat.GetEwma ();
+    }
+
+  Time now = Simulator::Now ();
+  if (!m_lastRxTime.IsNegative ())
+    {
+      m_interArrivalStat.Add ((now - m_lastRxTime).GetSeconds ());
+      m_interArrivalEwma = m_interArrivalStat.GetEwma ();
+    }
+  m_lastRxTime = now;
 }
 
 double
@@ -721,6 +1005,21 @@ WirelessModuleUtility::SendJammingSignal (double power, Time duration)
 
    NS_LOG_INFO(power);
   
+  if (!m_sendSignalCallback.IsNull ())
+    {
+      /*
+       * Jamming signals carry no data, the PHY only needs power and duration.
+       * The burst still counts as the bytes it would have taken on air, unless
+       * the PHY could not send it (power set to 0).
+       */
+      m_sendSignalCallback (power, duration);
+      if (power > 0)
+        {
+          m_totalBytesTx += numBytes;
+        }
+      return power;
+    }
+
   if (m_sendPacketCallback.IsNull ())
     {
       NS_FATAL_ERROR ("WirelessModuleUtility:Send packet callback is NOT set!");
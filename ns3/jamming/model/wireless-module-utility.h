@@ -31,6 +31,9 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/traced-value.h"
 #include "ns3/node.h"
+#include "streaming-statistic.h"
+
+#include <deque>
 
 namespace ns3 {
 
@@ -82,6 +85,12 @@ public:
    */
   typedef Callback<void, Ptr<Packet>, double&, int> UtilitySendPacketCallback;
 
+  /**
+   * Callback type for sending a payload-free jamming signal of a given power
+   * and duration in PHY.
+   */
+  typedef Callback<void, double&, Time> UtilitySendSignalCallback;
+
   /**
    * Callback for channel switch in PHY.
    */
@@ -107,14 +116,21 @@ public:
   Time GetThroughputUpdateInterval (void) const;
   void SetPdrWindowSize (uint32_t pdrWindowSize);
   uint32_t GetPdrWindowSize (void) const;
+  void SetPdrWindowTime (Time pdrWindowTime);
+  Time GetPdrWindowTime (void) const;
   void SetRssUpdateInterval (Time updateInterval);
   Time GetRssUpdateInterval (void) const;
+  void SetPeriodicRss (bool periodicRss);
+  bool GetPeriodicRss (void) const;
+  void SetStatisticsAlpha (double alpha);
+  double GetStatisticsAlpha (void) const;
 
   // access functions to member variables
   void SetRssMeasurementCallback (UtilityRssCallback RssCallback);
   void SetInclusionList (std::vector<std::string> list);
   void SetExclusionList (std::vector<std::string> list);
   void SetSendPacketCallback (UtilitySendPacketCallback sendPacketCallback);
+  void SetSendSignalCallback (UtilitySendSignalCallback sendSignalCallback);
   void SetChannelSwitchCallback (UtilityChannelSwitchCallback channelSwitchCallback);
   void SetStartTxCallback (UtilityTxCallback startTxCallback);
   void SetEndTxCallback (UtilityTxCallback endTxCallback);
@@ -136,6 +152,9 @@ public:
    * it stops receiving the rest of the packet as soon as the preambles are
    * received. This function invokes the StartRxHandler callback in reactive
    * jammer to stop receiving current packet and start sending jamming signals.
+   *
+   * The packet is shared by every PHY that received the transmission, neither
+   * this function nor the callbacks may modify it. Copy it first if needed.
    */
   bool StartRxHandler (Ptr<Packet> packet, double startRss);
  
@@ -147,7 +166,8 @@ public:
    * \param isSuccessfullyReceived True if packets was received successfully.
    *
    * This function forwards the received packet to appropriate callbacks. It
-   * is called inside by PHY layer driver at EndRx.
+   * is called inside by PHY layer driver at EndRx. As for StartRxHandler, the
+   * packet is shared and must not be modified.
    */
   void EndRxHandler (Ptr<Packet> packet, double averageRss,
                      const bool isSuccessfullyReceived);
@@ -174,6 +194,15 @@ public:
    */
   void EndTxHandler (Ptr<const Packet> packet, double txPower);
 
+  /**
+   * \brief Handle the start or end of a signal the PHY does not receive.
+   *
+   * This function is called by PHY layer driver when a signal it does not
+   * synchronize on, such as a jamming burst, starts or ends. It takes an RSS
+   * reading so that the busy time follows the channel without PeriodicRss.
+   */
+  void SignalChangeHandler (void);
+
   /**
    * \returns Total bytes received.
    */
@@ -200,9 +229,31 @@ public:
   double GetPdr (void) const;
 
   /**
-   * \returns Current node RSS.
+   * \returns PDR over the packets received in the last PdrWindowTime, 0 if
+   * the time window is disabled or no packet arrived in it.
+   */
+  double GetTimeWindowPdr (void) const;
+
+  /**
+   * \returns Current node RSS, measured at the time of the call.
+   */
+  double GetRss (void);
+
+  /**
+   * \returns Statistics of the average RSS of received packets, in dBm.
+   */
+  const StreamingStatistic & GetPacketRssStatistic (void) const;
+
+  /**
+   * \returns Statistics of the time between packet receptions, in seconds.
+   */
+  const StreamingStatistic & GetInterArrivalStatistic (void) const;
+
+  /**
+   * \returns Statistics of the fraction of each ThroughputUpdateInterval the
+   * node RSS was at or above BusyThreshold.
    */
-  double GetRss (void) const;
+  const StreamingStatistic & GetBusyFractionStatistic (void) const;
 
   /**
    * \brief Used by jammers to send out a jamming signal of a given power level
@@ -214,7 +265,9 @@ public:
    *
    * This function sends jamming signal of specific power via the PHY layer. If
    * the sending power is not supported by the PHY layer. The signal power will
-   * be scaled to the nearest supported value.
+   * be scaled to the nearest supported value. PHYs that set the send signal
+   * callback transmit the burst as energy only, without a packet; others get
+   * a dummy packet whose size matches the duration.
    */
   double SendJammingSignal (double power, Time duration);
 
@@ -237,9 +290,27 @@ public:
    */
   double SendMitigationMessage (Ptr<Packet> packet, double power);
 
+  /**
+   * \returns Approximate bytes held by this utility, including its PDR
+   * windows, header lists and statistics.
+   */
+  uint64_t GetFootprint (void) const;
+
    uint32_t GetTotalPkts ();
   uint32_t GetValidPkts();
 
+  /**
+   * \returns Packets received since the start, valid or not. Unlike
+   * GetTotalPkts this is not limited to the PDR window, so differences
+   * between two readings cover exactly the packets in between.
+   */
+  uint64_t GetReceivedPkts (void) const;
+
+  /**
+   * \returns Valid packets received since the start.
+   */
+  uint64_t GetReceivedValidPkts (void) const;
+
 private:
   void DoStart (void);
   void DoDispose (void);
@@ -271,33 +342,24 @@ private:
   void UpdateThroughput (void);
 
   /**
-   * \param packet Target packet.
-   * \param headerName Name of header to search for
-   * \returns Size of the header, 0 if header not found
+   * \brief Checks the packet against the header/trailer inclusion and
+   * exclusion lists.
    *
-   * This function searches the incoming packet for desired header/trailer.
-   * Modified from "void Packet::Print (std::ostream &os) const".
-   */
-  uint32_t FindHeader (Ptr<const Packet> packet, std::string headerName) const;
-
-  /**
-   * \brief Checks if headers/trailers in the inclusion list is in the given
-   * packet.
-   * \param packet Packet to check
-   * \returns True if headers/trailers in the inclusion list are found in the
-   * packet.
+   * \param packet Packet to check.
+   * \returns True if the packet carries a header/trailer of the inclusion list
+   * (or the inclusion list is empty) and none of the exclusion list.
    *
-   * This function checks if headers/trailers in the inclusion list are present
-   * in the given packet. Used in UpdateThroughput function to exclude certain
-   * types of packets. Note that if the inclusion list is empty (means we are
-   * accepting packets with any header/trailer), this function returns true.
+   * Both lists are checked together in a single pass over the packet metadata,
+   * comparing TypeId UIDs resolved by ResolveHeaderLists ().
    */
-  bool FindHeaderInInclusionList (Ptr<const Packet> packet);
+  bool IsPacketRecorded (Ptr<const Packet> packet);
 
   /**
-   * \see FindHeaderInInclusionList ();
+   * This function resolves the header/trailer names of the inclusion and
+   * exclusion lists to sorted TypeId UIDs. Names that are not registered yet
+   * are resolved again once more TypeIds have been registered.
    */
-  bool FindHeaderInExclusionList (Ptr<const Packet> packet);
+  void ResolveHeaderLists (void);
 
   /**
    * \param isPacketValid True if packet is successfully received.
@@ -314,11 +376,48 @@ private:
   void InsertIntoPdrArray (bool newPacketStatus);
 
   /**
-   * This function updates current RSS reading. Initially scheduled at
-   * StartRxHandler ().
+   * \param newPacketStatus True if packet is successfully received.
+   *
+   * This function records the packet status in the time window and updates
+   * the time window PDR.
+   */
+  void UpdateTimeWindowPdr (bool newPacketStatus);
+
+  /**
+   * This function drops packets older than PdrWindowTime from the time window
+   * and schedules itself for when the oldest remaining packet ages out, so
+   * the TimeWindowPdr trace follows the window without anyone reading it.
+   */
+  void ExpireTimeWindow (void);
+
+  /**
+   * This function updates current RSS reading. Called at the start and end
+   * of every reception; with PeriodicRss it also reschedules itself every
+   * RssUpdateInterval so the Rss trace is sampled while the node is idle.
    */
   void UpdateRss (void);
 
+  /**
+   * This function measures the node RSS through the PHY and records it.
+   * Does nothing if the RSS measurement callback is not set.
+   */
+  void MeasureRss (void);
+
+  /**
+   * \param rssW New node RSS reading, in watts.
+   *
+   * This function credits the time since the previous RSS reading to the busy
+   * time if the channel was busy, and then records the new reading.
+   */
+  void AccountBusyTime (double rssW);
+
+  /**
+   * \param averageRssW Average RSS over the packet, in watts.
+   *
+   * This function adds a packet reception to the streaming statistics.
+   */
+  void UpdateRxStatistics (double averageRssW);
+
   /**
    * \brief Convert dBm to Watts.
    *
@@ -351,20 +450,43 @@ private:
   EventId m_throughputUpdateEvent;    // event ID for throughput update event
   std::vector<std::string> m_headerInclusionList; // header/trailer inclusion list
   std::vector<std::string> m_headerExclusionList; // header/trailer exclusion list
+  std::vector<uint16_t> m_inclusionUids;  // sorted TypeId UIDs of the inclusion list
+  std::vector<uint16_t> m_exclusionUids;  // sorted TypeId UIDs of the exclusion list
+  uint32_t m_resolvedTypeIds;   // # of registered TypeIds at the last resolution, 0 if complete
 
   // PDR recording
   TracedValue<double> m_Pdr;    // variable keeping track of PDR
   uint32_t m_pdrWindowSize;     // PDR recording window size
   uint32_t m_numOfPktsRecvd;    // total # of packets received
   uint32_t m_pdrArrayCurIndex;  // current index of PDR array
-  std::vector<bool> m_pktStatusRecord;  // List of validity of last N packets
+  std::vector<uint64_t> m_pktStatusRecord;  // validity bits of last N packets, 64 per word
+  uint32_t m_validInWindow;     // # of set bits in m_pktStatusRecord
+  Time m_pdrWindowTime;         // PDR time window, 0 disables it
+  std::deque<std::pair<Time, bool> > m_pdrTimeRecord; // arrival time and validity in the time window
+  uint32_t m_validInTime;       // # of valid packets in m_pdrTimeRecord
+  TracedValue<double> m_timeWindowPdr; // PDR over the last m_pdrWindowTime
+  EventId m_expireTimeWindowEvent;     // event ID for the next time window expiry
 
   // RSS recording
   TracedValue<double> m_nodeRssW;   // current RSS reading at node, in watts, -1 indicates error
   Time m_rssUpdateInterval;         // RSS update interval
+  bool m_periodicRss;               // sample RSS every m_rssUpdateInterval
   EventId m_updateRssEvent;         // event ID for RSS update event
   TracedValue<double> m_avgPktRssW; // average packet RSS for previously received packet
 
+  // streaming statistics
+  double m_busyThresholdDbm;              // RSS at or above which the channel counts as busy
+  StreamingStatistic m_packetRssStat;     // per packet average RSS, in dBm
+  StreamingStatistic m_interArrivalStat;  // time between receptions, in seconds
+  StreamingStatistic m_busyFractionStat;  // busy fraction per throughput update interval
+  Time m_lastRxTime;            // end of the previous reception, negative before the first
+  Time m_lastRssTime;           // time of the previous RSS reading
+  bool m_channelBusy;           // previous RSS reading was at or above the threshold
+  Time m_busyTime;              // busy time in the current throughput update interval
+  TracedValue<double> m_packetRssEwma;    // EWMA of per packet RSS, in dBm
+  TracedValue<double> m_interArrivalEwma; // EWMA of inter-arrival time, in seconds
+  TracedValue<double> m_busyFractionEwma; // EWMA of busy fraction
+
   /**
    * Callback for measure current RSS (in watts). Done by PHY layer driver.
    * Returns -1 if no valid RSS calculation is available yet.
@@ -384,6 +506,11 @@ private:
    * protocols (PHY classes).
    */
   UtilitySendPacketCallback m_sendPacketCallback;
+  /**
+   * Callback for sending a jamming signal through the PHY layer without a
+   * packet. Optional, SendJammingSignal falls back to m_sendPacketCallback.
+   */
+  UtilitySendSignalCallback m_sendSignalCallback;
   /**
    * Callback for switching channels in PHY.
    *
@@ -412,6 +539,8 @@ private:
 
   uint32_t  m_totalPkts;
   uint32_t m_validPkts;
+  uint64_t m_receivedPkts;      // packets received since the start
+  uint64_t m_receivedValidPkts; // valid packets received since the start
 
 };
 
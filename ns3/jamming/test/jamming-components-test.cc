@@ -598,6 +598,7 @@ WirelessModuleUtilityTest::SimulateTwoNodes (double distance)
   // connect trace source
   Callback<void, double, double> rssTraceCallback;
   rssTraceCallback = MakeCallback (&WirelessModuleUtilityTest::NodeRss, this);
+  utilRecv->SetAttribute ("PeriodicRss", BooleanValue (true));
   utilRecv->TraceConnectWithoutContext ("Rss", rssTraceCallback);
   Callback<void, double, double> packetRssTraceCallback;
   packetRssTraceCallback = MakeCallback (&WirelessModuleUtilityTest::PacketRss, this);
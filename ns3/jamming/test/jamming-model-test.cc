@@ -0,0 +1,1563 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// ns3
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/boolean.h"
+#include "ns3/object-factory.h"
+#include "ns3/string.h"
+#include "ns3/llc-snap-header.h"
+// wifi
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-trailer.h"
+#include "ns3/wifi-phy-header.h"
+#include "ns3/wifi-phy-tag.h"
+// mobility and propagation
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+// energy
+#include "ns3/basic-energy-source-helper.h"
+// jamming
+#include "ns3/wireless-module-utility.h"
+#include "ns3/streaming-statistic.h"
+#include "ns3/reactive-jammer.h"
+#include "ns3/constant-jammer.h"
+#include "ns3/jamming-coordinator.h"
+#include "ns3/sweep-jammer.h"
+#include "ns3/eavesdropper-jammer.h"
+#include "ns3/jammer-helper.h"
+#include "ns3/jammer-container.h"
+#include "ns3/nsl-wifi-channel.h"
+#include "ns3/nsl-wifi-phy.h"
+#include "ns3/nsl-wifi-helper.h"
+#include "ns3/wireless-module-utility-helper.h"
+// other
+#include <algorithm>
+#include <math.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("JammingModelTestSuite");
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the PDR bookkeeping in WirelessModuleUtility. The sliding
+ * window PDR after every packet is checked against a scan of the last
+ * PdrWindowSize packets, and the TimeWindowPdr trace is checked to follow
+ * packets ageing out of PdrWindowTime without the value ever being read.
+ */
+class PdrWindowTest : public TestCase
+{
+public:
+  PdrWindowTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * \brief TimeWindowPdr trace function.
+   * \param oldValue Old PDR.
+   * \param pdr New PDR.
+   */
+  void TimeWindowPdr (double oldValue, double pdr);
+
+  std::vector<std::pair<Time, double> > m_timeWindowPdr;
+};
+
+PdrWindowTest::PdrWindowTest ()
+  : TestCase ("Test of the sliding and time window PDR.")
+{
+}
+
+void
+PdrWindowTest::TimeWindowPdr (double oldValue, double pdr)
+{
+  m_timeWindowPdr.push_back (std::make_pair (Simulator::Now (), pdr));
+}
+
+void
+PdrWindowTest::DoRun (void)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  // window sizes below, at and above one 64 bit word of packet status
+  uint32_t windows[] = {1, 7, 64, 100};
+  for (uint32_t window : windows)
+    {
+      Ptr<WirelessModuleUtility> utility = CreateObject<WirelessModuleUtility> ();
+      utility->SetPdrWindowSize (window);
+      std::vector<bool> record;
+      for (uint32_t i = 0; i < 500; i++)
+        {
+          bool valid = random->GetValue () < 0.7;
+          record.push_back (valid);
+          utility->EndRxHandler (packet, 1e-9, valid);
+
+          uint32_t total = std::min<uint32_t> (record.size (), window);
+          uint32_t validPkts = 0;
+          for (uint32_t j = record.size () - total; j < record.size (); j++)
+            {
+              validPkts += record[j] ? 1 : 0;
+            }
+          NS_TEST_ASSERT_MSG_EQ (utility->GetPdr (), (double) validPkts / total,
+                                 "window " << window << ", PDR after packet " << i);
+        }
+    }
+
+  // one valid packet at 0.1s, one corrupted at 0.2s, 1s window
+  Ptr<WirelessModuleUtility> utility = CreateObject<WirelessModuleUtility> ();
+  utility->SetPdrWindowTime (Seconds (1));
+  utility->TraceConnectWithoutContext ("TimeWindowPdr",
+                                       MakeCallback (&PdrWindowTest::TimeWindowPdr, this));
+  Simulator::Schedule (Seconds (0.1), &WirelessModuleUtility::EndRxHandler, utility, packet, 1e-9, true);
+  Simulator::Schedule (Seconds (0.2), &WirelessModuleUtility::EndRxHandler, utility, packet, 1e-9, false);
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_timeWindowPdr.size (), 3, "PDR changes three times");
+  NS_TEST_ASSERT_MSG_EQ (m_timeWindowPdr[0].first, Seconds (0.1), "first packet");
+  NS_TEST_ASSERT_MSG_EQ (m_timeWindowPdr[0].second, 1.0, "only the valid packet");
+  NS_TEST_ASSERT_MSG_EQ (m_timeWindowPdr[1].first, Seconds (0.2), "second packet");
+  NS_TEST_ASSERT_MSG_EQ (m_timeWindowPdr[1].second, 0.5, "both packets");
+  NS_TEST_ASSERT_MSG_EQ (m_timeWindowPdr[2].first, Seconds (1.1), "valid packet ages out");
+  NS_TEST_ASSERT_MSG_EQ (m_timeWindowPdr[2].second, 0.0, "only the corrupted packet");
+  NS_TEST_ASSERT_MSG_EQ (utility->GetTimeWindowPdr (), 0.0, "empty window");
+
+  utility->Dispose ();
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of StreamingStatistic: EWMA, minimum and maximum, percentiles
+ * read from linear and logarithmic histograms, and the alpha range the
+ * StatisticsAlpha attribute accepts.
+ */
+class StreamingStatisticTest : public TestCase
+{
+public:
+  StreamingStatisticTest ();
+
+private:
+  void DoRun (void);
+};
+
+StreamingStatisticTest::StreamingStatisticTest ()
+  : TestCase ("Test of streaming statistics.")
+{
+}
+
+void
+StreamingStatisticTest::DoRun (void)
+{
+  double tolerance = 1e-9;
+
+  // one sample in the middle of each of 10 buckets over [0, 10]
+  StreamingStatistic linear (0, 10, 10);
+  NS_TEST_ASSERT_MSG_EQ (linear.GetPercentile (0.5), 0, "no samples");
+  linear.SetAlpha (0.5);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      linear.Add (i + 0.5);
+    }
+  NS_TEST_ASSERT_MSG_EQ (linear.GetCount (), 10, "count");
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetMin (), 0.5, tolerance, "minimum");
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetMax (), 9.5, tolerance, "maximum");
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetPercentile (0.5), 5, tolerance, "median at the 5th bucket edge");
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetPercentile (0.25), 2.5, tolerance, "interpolated within a bucket");
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetPercentile (0), 0.5, tolerance, "clamped to the minimum");
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetPercentile (1), 9.5, tolerance, "clamped to the maximum");
+
+  // the first sample seeds the EWMA, later ones move it by alpha
+  double ewma = 0.5;
+  for (uint32_t i = 1; i < 10; i++)
+    {
+      ewma += 0.5 * (i + 0.5 - ewma);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetEwma (), ewma, tolerance, "EWMA");
+
+  // out of range samples land in the edge buckets but keep the true maximum
+  linear.Add (100);
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetMax (), 100, tolerance, "maximum beyond the range");
+  NS_TEST_ASSERT_MSG_EQ_TOL (linear.GetPercentile (1), 10, tolerance, "top bucket edge");
+
+  linear.Reset ();
+  NS_TEST_ASSERT_MSG_EQ (linear.GetCount (), 0, "reset count");
+  NS_TEST_ASSERT_MSG_EQ (linear.GetAlpha (), 0.5, "reset keeps alpha");
+
+  // one sample per decade over [1, 1000]
+  StreamingStatistic logarithmic (1, 1000, 3, true);
+  logarithmic.Add (5);
+  logarithmic.Add (50);
+  logarithmic.Add (500);
+  NS_TEST_ASSERT_MSG_EQ_TOL (logarithmic.GetPercentile (0.5), sqrt (1000.0), tolerance, "geometric middle of the 2nd decade");
+  NS_TEST_ASSERT_MSG_EQ_TOL (logarithmic.GetPercentile (2.0 / 3), 100, tolerance, "decade edge");
+
+  // alpha must be in (0, 1]
+  Ptr<WirelessModuleUtility> utility = CreateObject<WirelessModuleUtility> ();
+  NS_TEST_ASSERT_MSG_EQ (utility->SetAttributeFailSafe ("StatisticsAlpha", DoubleValue (0)), false, "alpha 0 rejected");
+  NS_TEST_ASSERT_MSG_EQ (utility->SetAttributeFailSafe ("StatisticsAlpha", DoubleValue (1)), true, "alpha 1 accepted");
+  NS_TEST_ASSERT_MSG_EQ (utility->GetPacketRssStatistic ().GetAlpha (), 1, "alpha applied");
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the ReactiveJammer decisions. With a fixed stream, the
+ * decisions equal one uniform variate per packet compared against the fixed
+ * probability, whatever RandomBatchSize is and however batch decisions and
+ * receptions are interleaved.
+ */
+class ReactiveJammerDecisionTest : public TestCase
+{
+public:
+  ReactiveJammerDecisionTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * \brief Decision trace function.
+   * \param packet Packet whose reception started.
+   * \param jam True if the jammer reacts to it.
+   */
+  void Decision (Ptr<const Packet> packet, bool jam);
+
+  std::vector<uint8_t> m_decisions;
+};
+
+ReactiveJammerDecisionTest::ReactiveJammerDecisionTest ()
+  : TestCase ("Test of reactive jammer decisions per stream.")
+{
+}
+
+void
+ReactiveJammerDecisionTest::Decision (Ptr<const Packet> packet, bool jam)
+{
+  m_decisions.push_back (jam);
+}
+
+void
+ReactiveJammerDecisionTest::DoRun (void)
+{
+  int64_t stream = 11;
+  uint32_t packets = 600;
+  uint32_t probabilityChange = 300; // packet from which 0.6 applies
+
+  // one variate per packet, straight from the stream
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (stream);
+  std::vector<uint8_t> expected;
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      expected.push_back (random->GetValue () < (i < probabilityChange ? 0.3 : 0.6));
+    }
+
+  Ptr<Packet> packet = Create<Packet> (100);
+  uint32_t batchSizes[] = {1, 7, 256, 1000};
+  for (uint32_t batchSize : batchSizes)
+    {
+      Ptr<ReactiveJammer> jammer = CreateObject<ReactiveJammer> ();
+      jammer->SetAttribute ("ReactiveJammerReactionStrategy",
+                            UintegerValue (ReactiveJammer::FIXED_PROBABILITY));
+      jammer->SetAttribute ("ReactiveJammerFixedProbability", DoubleValue (0.3));
+      jammer->SetAttribute ("ReactiveJammerRandomBatchSize", UintegerValue (batchSize));
+      jammer->AssignStreams (stream);
+      jammer->TraceConnectWithoutContext ("Decision",
+                                          MakeCallback (&ReactiveJammerDecisionTest::Decision, this));
+      jammer->StartJammer ();
+
+      // batches of growing size, each followed by one reception
+      m_decisions.clear ();
+      uint32_t count = 1;
+      while (m_decisions.size () < packets)
+        {
+          if (m_decisions.size () >= probabilityChange)
+            {
+              jammer->SetFixedProbability (0.6);
+            }
+          uint32_t n = std::min (count, probabilityChange > m_decisions.size () ?
+                                 probabilityChange - (uint32_t) m_decisions.size () :
+                                 packets - (uint32_t) m_decisions.size ());
+          std::vector<uint8_t> batch (n);
+          uint32_t jammed = jammer->DecidePackets (n, batch.data ());
+          uint32_t ones = 0;
+          for (uint8_t jam : batch)
+            {
+              ones += jam;
+            }
+          NS_TEST_ASSERT_MSG_EQ (jammed, ones, "jammed count matches the decisions");
+          m_decisions.insert (m_decisions.end (), batch.begin (), batch.end ());
+          if (m_decisions.size () != probabilityChange && m_decisions.size () < packets)
+            {
+              jammer->StartRxHandler (packet, 1e-9);
+            }
+          count++;
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (m_decisions.size (), packets, "batch size " << batchSize << ", decisions");
+      for (uint32_t i = 0; i < packets; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t) m_decisions[i], (uint32_t) expected[i],
+                                 "batch size " << batchSize << ", decision " << i);
+        }
+      jammer->StopJammer ();
+      jammer->Dispose ();
+    }
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Jammer without a radio. The coordinator test decides from its on/off
+ * state which packets the target loses.
+ */
+class CoordinatedTestJammer : public Jammer
+{
+public:
+  virtual void SetUtility (Ptr<WirelessModuleUtility> utility) {}
+  virtual void SetEnergySource (Ptr<EnergySource> source) {}
+
+private:
+  virtual void DoJamming (void) {}
+  virtual void DoStopJammer (void) {}
+  virtual bool DoStartRxHandler (Ptr<Packet> packet, double startRss) { return false; }
+  virtual bool DoEndRxHandler (Ptr<Packet> packet, double averageRss) { return false; }
+  virtual void DoEndTxHandler (Ptr<Packet> packet, double txPower) {}
+};
+
+/**
+ * Test case of JammingCoordinator. Of two jammers only the first one makes
+ * the target lose packets. The coordinator tries both, then keeps the first
+ * one on. Degradation is measured over the packets of each interval, so once
+ * the target stops receiving the reported degradation drops to 0 instead of
+ * repeating the last PDR window.
+ */
+class JammingCoordinatorTest : public TestCase
+{
+public:
+  JammingCoordinatorTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * \brief Delivers one packet to the target, lost if the effective jammer is
+   * on, and schedules the next one until the traffic ends.
+   */
+  void Receive (void);
+
+  /**
+   * \brief Allocation trace function.
+   * \param active Number of jammers switched on.
+   * \param spent Energy spent so far.
+   * \param degradation PDR degradation over the last interval.
+   */
+  void Allocation (uint32_t active, double spent, double degradation);
+
+  Ptr<Jammer> m_effective;
+  Ptr<Jammer> m_ineffective;
+  Ptr<WirelessModuleUtility> m_target;
+  Time m_trafficEnd;
+  std::vector<double> m_degradation;
+  std::vector<bool> m_effectiveOn;
+  std::vector<bool> m_ineffectiveOn;
+};
+
+JammingCoordinatorTest::JammingCoordinatorTest ()
+  : TestCase ("Test of the jamming coordinator.")
+{
+}
+
+void
+JammingCoordinatorTest::Receive (void)
+{
+  m_target->EndRxHandler (Create<Packet> (100), 1e-9, !m_effective->IsJammerOn ());
+  if (Simulator::Now () + MilliSeconds (10) < m_trafficEnd)
+    {
+      Simulator::Schedule (MilliSeconds (10), &JammingCoordinatorTest::Receive, this);
+    }
+}
+
+void
+JammingCoordinatorTest::Allocation (uint32_t active, double spent, double degradation)
+{
+  m_degradation.push_back (degradation);
+  m_effectiveOn.push_back (m_effective->IsJammerOn ());
+  m_ineffectiveOn.push_back (m_ineffective->IsJammerOn ());
+}
+
+void
+JammingCoordinatorTest::DoRun (void)
+{
+  Ptr<JammingCoordinator> coordinator = CreateObject<JammingCoordinator> ();
+  coordinator->SetAttribute ("MaxActive", UintegerValue (1));
+  coordinator->TraceConnectWithoutContext ("Allocation",
+                                           MakeCallback (&JammingCoordinatorTest::Allocation, this));
+
+  BasicEnergySourceHelper sourceHelper;
+  m_effective = CreateObject<CoordinatedTestJammer> ();
+  m_ineffective = CreateObject<CoordinatedTestJammer> ();
+  Ptr<Jammer> jammers[] = {m_effective, m_ineffective};
+  for (Ptr<Jammer> jammer : jammers)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      sourceHelper.Install (node);
+      node->AggregateObject (jammer);
+      coordinator->AddJammer (jammer);
+    }
+
+  // a packet every 10ms, off the decision times, until 5.5s
+  m_target = CreateObject<WirelessModuleUtility> ();
+  m_trafficEnd = Seconds (5.5);
+  coordinator->AddTarget (m_target);
+  Simulator::Schedule (MilliSeconds (5), &JammingCoordinatorTest::Receive, this);
+  coordinator->Start ();
+  Simulator::Stop (Seconds (7.5));
+  Simulator::Run ();
+
+  // decisions at 0s .. 7s, each accounting the second before it
+  double degradation[] = {0, 1, 0, 1, 1, 1, 1, 0};
+  bool effectiveOn[] = {true, false, true, true, true, true, true, true};
+  NS_TEST_ASSERT_MSG_EQ (m_degradation.size (), 8, "one decision per second");
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_degradation[i], degradation[i], 1e-9, "degradation at " << i << "s");
+      NS_TEST_ASSERT_MSG_EQ ((bool) m_effectiveOn[i], effectiveOn[i], "effective jammer at " << i << "s");
+      NS_TEST_ASSERT_MSG_EQ ((bool) m_ineffectiveOn[i], !effectiveOn[i], "ineffective jammer at " << i << "s");
+    }
+
+  coordinator->Dispose ();
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the range NslWifiChannel culls receivers with. The range must
+ * follow changes of the PHYs' RX sensitivity and RX gain and of the loss
+ * model's attributes made after it was first derived, from the next event
+ * time on: the loss at the range must exceed the allowed loss, and the loss
+ * one table step closer must not.
+ */
+class NslWifiChannelRangeTest : public TestCase
+{
+public:
+  NslWifiChannelRangeTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * Checks the culling range against the loss model.
+   *
+   * \param channel the channel
+   * \param txPowerDbm the tx power (dBm)
+   * \param rxThresholdDbm the lowest RX sensitivity less RX gain (dBm)
+   * \param step what changed before the check
+   */
+  void CheckRange (Ptr<NslWifiChannel> channel, double txPowerDbm, double rxThresholdDbm,
+                   std::string step);
+  /**
+   * Runs CheckRange in an event one second later, the channel reads the
+   * changes once per simulation time.
+   *
+   * \param channel the channel
+   * \param txPowerDbm the tx power (dBm)
+   * \param rxThresholdDbm the lowest RX sensitivity less RX gain (dBm)
+   * \param step what changed before the check
+   */
+  void CheckRangeLater (Ptr<NslWifiChannel> channel, double txPowerDbm, double rxThresholdDbm,
+                        std::string step);
+
+  /**
+   * \param distance a distance (m)
+   * \return the loss of m_loss over the distance (dB)
+   */
+  double GetLoss (double distance);
+
+  Ptr<FriisPropagationLossModel> m_loss;
+};
+
+NslWifiChannelRangeTest::NslWifiChannelRangeTest ()
+  : TestCase ("Test of the NslWifiChannel culling range.")
+{
+}
+
+double
+NslWifiChannelRangeTest::GetLoss (double distance)
+{
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (distance, 0, 0));
+  return -m_loss->CalcRxPower (0.0, a, b);
+}
+
+void
+NslWifiChannelRangeTest::CheckRange (Ptr<NslWifiChannel> channel, double txPowerDbm,
+                                     double rxThresholdDbm, std::string step)
+{
+  double range = channel->GetMaxRange (txPowerDbm);
+  double maxLossDb = txPowerDbm - rxThresholdDbm;
+  NS_TEST_ASSERT_MSG_GT (range, 0, step << ": range is derived from Friis");
+  NS_TEST_ASSERT_MSG_GT (GetLoss (range), maxLossDb, step << ": nothing received beyond the range");
+  // the loss table grows by 10% per entry
+  NS_TEST_ASSERT_MSG_EQ (GetLoss (range / 1.1) <= maxLossDb, true, step << ": range is not stale");
+}
+
+void
+NslWifiChannelRangeTest::CheckRangeLater (Ptr<NslWifiChannel> channel, double txPowerDbm,
+                                          double rxThresholdDbm, std::string step)
+{
+  Simulator::Schedule (Seconds (1), &NslWifiChannelRangeTest::CheckRange, this,
+                       channel, txPowerDbm, rxThresholdDbm, step);
+  Simulator::Run ();
+}
+
+void
+NslWifiChannelRangeTest::DoRun (void)
+{
+  m_loss = CreateObject<FriisPropagationLossModel> ();
+  Ptr<NslWifiChannel> channel = CreateObject<NslWifiChannel> ();
+  channel->SetPropagationLossModel (m_loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  std::vector<Ptr<NslWifiPhy> > phys;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (100.0 * i, 0, 0));
+      Ptr<NslWifiPhy> phy = CreateObject<NslWifiPhy> ();
+      phy->SetRxSensitivity (-101);
+      phy->SetRxGain (0);
+      phy->SetMobility (mobility);
+      phy->SetChannel (channel);
+      phys.push_back (phy);
+    }
+
+  CheckRange (channel, 20, -101, "initial");
+  // neither the PHYs nor the model tell the channel about these changes
+  phys[1]->SetRxSensitivity (-111);
+  CheckRangeLater (channel, 20, -111, "RX sensitivity lowered");
+  phys[1]->SetRxGain (10);
+  CheckRangeLater (channel, 20, -121, "RX gain raised");
+  phys[1]->SetRxGain (0);
+  CheckRangeLater (channel, 20, -111, "RX gain restored");
+  m_loss->SetAttribute ("SystemLoss", DoubleValue (10.0));
+  CheckRangeLater (channel, 20, -111, "system loss of 10 dB");
+  m_loss->SetAttribute ("Frequency", DoubleValue (2.4e9));
+  CheckRangeLater (channel, 20, -111, "frequency changed");
+
+  for (uint32_t i = 0; i < phys.size (); i++)
+    {
+      phys[i]->Dispose ();
+    }
+  channel->Dispose ();
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the NslWifiChannel link cache. Two channels with the same PHY
+ * layout are built, one with LinkCache and one without, and the delay and RX
+ * power of every PHY pair must match between them: on the first lookup, once
+ * served from the cache, at another tx power, after PHYs change course and,
+ * without InvalidateLinkCache, after an attribute of the loss model changes.
+ */
+class NslWifiChannelLinkCacheTest : public TestCase
+{
+public:
+  NslWifiChannelLinkCacheTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * Compares every link of the cached channel with the uncached one.
+   *
+   * \param txPowerDbm the tx power (dBm)
+   * \param step what happened before the check
+   */
+  void CheckLinks (double txPowerDbm, std::string step);
+
+  Ptr<NslWifiChannel> m_channels[2];            //!< With and without LinkCache
+  Ptr<PropagationLossModel> m_losses[2];        //!< Loss model of each channel
+  std::vector<Ptr<NslWifiPhy> > m_phys[2];      //!< PHYs of each channel
+  std::vector<Ptr<ConstantPositionMobilityModel> > m_mobilities[2]; //!< Their mobility models
+};
+
+NslWifiChannelLinkCacheTest::NslWifiChannelLinkCacheTest ()
+  : TestCase ("Test of the NslWifiChannel link cache against uncached links.")
+{
+}
+
+void
+NslWifiChannelLinkCacheTest::CheckLinks (double txPowerDbm, std::string step)
+{
+  for (uint32_t i = 0; i < m_phys[0].size (); i++)
+    {
+      for (uint32_t j = 0; j < m_phys[0].size (); j++)
+        {
+          if (i == j)
+            {
+              continue;
+            }
+          Time delay, expectedDelay;
+          double rx, expectedRx;
+          m_channels[0]->GetLink (m_phys[0][i], m_phys[0][j], txPowerDbm, delay, rx);
+          m_channels[1]->GetLink (m_phys[1][i], m_phys[1][j], txPowerDbm, expectedDelay, expectedRx);
+          NS_TEST_ASSERT_MSG_EQ (delay, expectedDelay, step << ", delay of link " << i << "->" << j);
+          NS_TEST_ASSERT_MSG_EQ_TOL (rx, expectedRx, 1e-9, step << ", rx power of link " << i << "->" << j);
+        }
+    }
+}
+
+void
+NslWifiChannelLinkCacheTest::DoRun (void)
+{
+  std::string lossModels[] = {"ns3::FriisPropagationLossModel",
+                              "ns3::LogDistancePropagationLossModel",
+                              "ns3::ThreeLogDistancePropagationLossModel"};
+  for (const std::string &lossModel : lossModels)
+    {
+      for (uint32_t c = 0; c < 2; c++)
+        {
+          ObjectFactory loss;
+          loss.SetTypeId (lossModel);
+          m_channels[c] = CreateObject<NslWifiChannel> ();
+          m_channels[c]->SetAttribute ("LinkCache", BooleanValue (c == 0));
+          m_losses[c] = loss.Create<PropagationLossModel> ();
+          m_channels[c]->SetPropagationLossModel (m_losses[c]);
+          m_channels[c]->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+          m_phys[c].clear ();
+          m_mobilities[c].clear ();
+          for (uint32_t i = 0; i < 9; i++)
+            {
+              Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+              mobility->SetPosition (Vector (20.0 * (i % 3), 20.0 * (i / 3), 0));
+              Ptr<NslWifiPhy> phy = CreateObject<NslWifiPhy> ();
+              phy->SetMobility (mobility);
+              phy->SetChannel (m_channels[c]);
+              m_phys[c].push_back (phy);
+              m_mobilities[c].push_back (mobility);
+            }
+        }
+
+      CheckLinks (20, lossModel + " first lookup");
+      CheckLinks (20, lossModel + " cached");
+      CheckLinks (5, lossModel + " other tx power");
+      // a sender and a receiver move, their cached links must be dropped
+      for (uint32_t c = 0; c < 2; c++)
+        {
+          m_mobilities[c][0]->SetPosition (Vector (-60, 10, 1));
+          m_mobilities[c][4]->SetPosition (Vector (300, 0, 0));
+        }
+      CheckLinks (20, lossModel + " after course change");
+      CheckLinks (20, lossModel + " cached after course change");
+
+      // the channel is not told, the change shows from the next event time
+      for (uint32_t c = 0; c < 2; c++)
+        {
+          if (lossModel == "ns3::FriisPropagationLossModel")
+            {
+              m_losses[c]->SetAttribute ("Frequency", DoubleValue (2.4e9));
+            }
+          else if (lossModel == "ns3::LogDistancePropagationLossModel")
+            {
+              m_losses[c]->SetAttribute ("Exponent", DoubleValue (3.5));
+            }
+          else
+            {
+              m_losses[c]->SetAttribute ("Exponent0", DoubleValue (2.5));
+            }
+        }
+      Simulator::Schedule (Seconds (1), &NslWifiChannelLinkCacheTest::CheckLinks, this,
+                           20, lossModel + " after attribute change");
+      Simulator::Run ();
+      CheckLinks (20, lossModel + " cached after attribute change");
+
+      for (uint32_t c = 0; c < 2; c++)
+        {
+          for (uint32_t i = 0; i < m_phys[c].size (); i++)
+            {
+              m_phys[c][i]->Dispose ();
+            }
+          m_channels[c]->Dispose ();
+        }
+    }
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of BatchDelivery against per receiver events. The same grid of
+ * ad hoc nodes broadcasts frames in turn, with a jamming burst over some of
+ * them, once with each delivery mode. Every PHY must see the same reception
+ * starts, ends and drops at the same times in both runs; only the order of
+ * events due at the same time may differ.
+ */
+class NslWifiChannelBatchDeliveryTest : public TestCase
+{
+public:
+  NslWifiChannelBatchDeliveryTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * Runs the scenario once.
+   *
+   * \param batch whether the channel batches deliveries
+   */
+  void RunOnce (bool batch);
+
+  /**
+   * Broadcasts a frame from a device, then schedules the next device.
+   *
+   * \param devices the devices taking turns
+   * \param index the device sending now
+   * \param count frames left to send
+   */
+  static void Broadcast (NetDeviceContainer devices, uint32_t index, uint32_t count);
+
+  /**
+   * \brief PhyRxBegin trace function.
+   * \param context the trace path, naming the node
+   * \param packet the frame
+   */
+  void RxBegin (std::string context, Ptr<const Packet> packet);
+  /**
+   * \brief PhyRxEnd trace function.
+   * \param context the trace path, naming the node
+   * \param packet the frame
+   */
+  void RxEnd (std::string context, Ptr<const Packet> packet);
+  /**
+   * \brief PhyRxDrop trace function.
+   * \param context the trace path, naming the node
+   * \param packet the frame
+   * \param reason why it was dropped
+   */
+  void RxDrop (std::string context, Ptr<const Packet> packet, WifiPhyRxfailureReason reason);
+  /**
+   * Records a PHY event of the current run.
+   *
+   * \param kind the kind of event
+   * \param context the trace path, naming the node
+   */
+  void Record (std::string kind, std::string context);
+
+  std::vector<std::string> m_events; //!< Events of the current run
+};
+
+NslWifiChannelBatchDeliveryTest::NslWifiChannelBatchDeliveryTest ()
+  : TestCase ("Test of NslWifiChannel BatchDelivery against one event per receiver.")
+{
+}
+
+void
+NslWifiChannelBatchDeliveryTest::Broadcast (NetDeviceContainer devices, uint32_t index, uint32_t count)
+{
+  Ptr<NetDevice> device = devices.Get (index);
+  device->Send (Create<Packet> (500), device->GetBroadcast (), 0x0800);
+  if (count > 1)
+    {
+      Simulator::Schedule (MilliSeconds (3), &NslWifiChannelBatchDeliveryTest::Broadcast, devices,
+                           (index + 1) % devices.GetN (), count - 1);
+    }
+}
+
+void
+NslWifiChannelBatchDeliveryTest::Record (std::string kind, std::string context)
+{
+  std::ostringstream event;
+  event << Simulator::Now ().GetTimeStep () << " " << context << " " << kind;
+  m_events.push_back (event.str ());
+}
+
+void
+NslWifiChannelBatchDeliveryTest::RxBegin (std::string context, Ptr<const Packet> packet)
+{
+  Record ("begin", context);
+}
+
+void
+NslWifiChannelBatchDeliveryTest::RxEnd (std::string context, Ptr<const Packet> packet)
+{
+  Record ("end", context);
+}
+
+void
+NslWifiChannelBatchDeliveryTest::RxDrop (std::string context, Ptr<const Packet> packet,
+                                         WifiPhyRxfailureReason reason)
+{
+  Record ("drop", context);
+}
+
+void
+NslWifiChannelBatchDeliveryTest::RunOnce (bool batch)
+{
+  m_events.clear ();
+  NodeContainer nodes;
+  nodes.Create (16);
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("DsssRate1Mbps"),
+                                "ControlMode", StringValue ("DsssRate1Mbps"));
+  NslWifiPhyHelper wifiPhy = NslWifiPhyHelper::Default ();
+  NslWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel");
+  Ptr<NslWifiChannel> channel = wifiChannel.Create ();
+  channel->SetAttribute ("BatchDelivery", BooleanValue (batch));
+  wifiPhy.SetChannel (channel);
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (150.0),
+                                 "DeltaY", DoubleValue (150.0),
+                                 "GridWidth", UintegerValue (4));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  // node ids restart at 0 after Simulator::Destroy, the paths match across runs
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxBegin",
+                   MakeCallback (&NslWifiChannelBatchDeliveryTest::RxBegin, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEnd",
+                   MakeCallback (&NslWifiChannelBatchDeliveryTest::RxEnd, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxDrop",
+                   MakeCallback (&NslWifiChannelBatchDeliveryTest::RxDrop, this));
+
+  // frames overlap at the nodes in between, and a burst drops some more
+  Simulator::Schedule (Seconds (1), &NslWifiChannelBatchDeliveryTest::Broadcast, devices, 0, 48);
+  Ptr<NslWifiPhy> jammer = DynamicCast<NslWifiPhy> (DynamicCast<WifiNetDevice> (devices.Get (5))->GetPhy ());
+  Simulator::Schedule (Seconds (1) + MilliSeconds (40), &NslWifiPhy::SendSignal, jammer,
+                       MilliSeconds (10), 0);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  std::sort (m_events.begin (), m_events.end ());
+}
+
+void
+NslWifiChannelBatchDeliveryTest::DoRun (void)
+{
+  RunOnce (false);
+  std::vector<std::string> expected = m_events;
+  RunOnce (true);
+
+  NS_TEST_ASSERT_MSG_GT (expected.size (), 0, "frames were received");
+  NS_TEST_ASSERT_MSG_EQ (m_events.size (), expected.size (), "as many PHY events with batching");
+  for (uint32_t i = 0; i < m_events.size () && i < expected.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_events[i], expected[i], "PHY event " << i);
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the frame NslWifiPhy hands on. Two frames carrying a PHY tag
+ * and a DSSS SIG header, as WifiPhy puts them on the air, reach a PHY back
+ * to back: it synchronizes on the first and drops the second. The
+ * WirelessModuleUtility, excluding frames with a SIG header, must count the
+ * bytes of the MAC frame, and the drop trace must see the MAC frame.
+ */
+class NslWifiPhyRxFrameTest : public TestCase
+{
+public:
+  NslWifiPhyRxFrameTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * \brief PhyRxDrop trace function.
+   * \param packet the dropped frame
+   * \param reason why it was dropped
+   */
+  void RxDrop (Ptr<const Packet> packet, WifiPhyRxfailureReason reason);
+
+  std::vector<uint32_t> m_dropSizes; //!< Sizes of the dropped frames
+};
+
+NslWifiPhyRxFrameTest::NslWifiPhyRxFrameTest ()
+  : TestCase ("Test of the frame NslWifiPhy hands to the MAC, utility and traces.")
+{
+}
+
+void
+NslWifiPhyRxFrameTest::RxDrop (Ptr<const Packet> packet, WifiPhyRxfailureReason reason)
+{
+  m_dropSizes.push_back (packet->GetSize ());
+}
+
+void
+NslWifiPhyRxFrameTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("DsssRate1Mbps"),
+                                "ControlMode", StringValue ("DsssRate1Mbps"));
+  NslWifiPhyHelper wifiPhy = NslWifiPhyHelper::Default ();
+  NslWifiChannelHelper wifiChannel = NslWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  WirelessModuleUtilityHelper utilityHelper;
+  std::vector<std::string> exclusionList;
+  exclusionList.push_back ("ns3::DsssSigHeader");
+  utilityHelper.SetExclusionList (exclusionList);
+  WirelessModuleUtilityContainer utilities = utilityHelper.Install (nodes.Get (1));
+
+  Ptr<NslWifiPhy> phy = DynamicCast<NslWifiPhy> (DynamicCast<WifiNetDevice> (devices.Get (1))->GetPhy ());
+  phy->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&NslWifiPhyRxFrameTest::RxDrop, this));
+
+  // a broadcast data frame as the MAC of node 0 builds it
+  Ptr<Packet> frame = Create<Packet> (100);
+  LlcSnapHeader llc;
+  llc.SetType (0x0800);
+  frame->AddHeader (llc);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_DATA);
+  hdr.SetAddr1 (Mac48Address::GetBroadcast ());
+  hdr.SetAddr2 (Mac48Address::ConvertFrom (devices.Get (0)->GetAddress ()));
+  hdr.SetAddr3 (Mac48Address::GetBroadcast ());
+  hdr.SetDsNotFrom ();
+  hdr.SetDsNotTo ();
+  frame->AddHeader (hdr);
+  WifiMacTrailer fcs;
+  frame->AddTrailer (fcs);
+  uint32_t macSize = frame->GetSize ();
+
+  // and as WifiPhy puts it on the air, shared by all receivers
+  WifiTxVector txVector;
+  txVector.SetMode (WifiPhy::GetDsssRate1Mbps ());
+  txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  txVector.SetChannelWidth (22);
+  Ptr<Packet> onAir = frame->Copy ();
+  DsssSigHeader sig;
+  sig.SetRate (txVector.GetMode ().GetDataRate (22));
+  onAir->AddHeader (sig);
+  onAir->AddPacketTag (WifiPhyTag (WIFI_PREAMBLE_LONG, WIFI_MOD_CLASS_DSSS, 1));
+
+  Simulator::Schedule (Seconds (1), &NslWifiPhy::StartReceivePacket, phy, onAir, -50.0,
+                       txVector, WIFI_PREAMBLE_LONG);
+  Simulator::Schedule (Seconds (1) + MicroSeconds (10), &NslWifiPhy::StartReceivePacket, phy,
+                       onAir, -50.0, txVector, WIFI_PREAMBLE_LONG);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (utilities.Get (0)->GetTotalBytesRx (), macSize, "bytes of one MAC frame received");
+  NS_TEST_ASSERT_MSG_EQ (m_dropSizes.size (), 1, "frame during reception dropped");
+  NS_TEST_ASSERT_MSG_EQ (m_dropSizes[0], macSize, "drop trace sees the MAC frame");
+  NS_TEST_ASSERT_MSG_EQ (onAir->GetSize (), macSize + sig.GetSerializedSize (), "shared frame untouched");
+
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the busy time of a node next to a constant jammer, without
+ * PeriodicRss. The jammer sends 100 ms bursts every 500 ms that start and end
+ * between the throughput updates, and the PHY receives no packet, so only the
+ * RSS readings at the start and end of each burst can see it: each one
+ * second interval must be 20% busy.
+ */
+class WirelessModuleUtilityBusyTimeTest : public TestCase
+{
+public:
+  WirelessModuleUtilityBusyTimeTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * Records the busy fraction of the last throughput update interval.
+   */
+  void Probe (void);
+
+  Ptr<WirelessModuleUtility> m_utility; //!< Utility of the node next to the jammer
+  std::vector<double> m_busyFractions;  //!< Busy fraction at each probe
+};
+
+WirelessModuleUtilityBusyTimeTest::WirelessModuleUtilityBusyTimeTest ()
+  : TestCase ("Test of the busy fraction under jamming bursts without PeriodicRss.")
+{
+}
+
+void
+WirelessModuleUtilityBusyTimeTest::Probe (void)
+{
+  // with an alpha of 1 the EWMA is the last sample
+  m_busyFractions.push_back (m_utility->GetBusyFractionStatistic ().GetEwma ());
+}
+
+void
+WirelessModuleUtilityBusyTimeTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("DsssRate1Mbps"),
+                                "ControlMode", StringValue ("DsssRate1Mbps"));
+  NslWifiPhyHelper wifiPhy = NslWifiPhyHelper::Default ();
+  wifiPhy.Set ("TxPowerStart", DoubleValue (0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (20));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (2));
+  NslWifiChannelHelper wifiChannel = NslWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 0.0));
+  positions->Add (Vector (5.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Install (nodes);
+
+  WirelessModuleUtilityHelper utilityHelper;
+  utilityHelper.Set ("PeriodicRss", BooleanValue (false));
+  utilityHelper.Set ("StatisticsAlpha", DoubleValue (1.0));
+  m_utility = utilityHelper.Install (nodes).Get (1);
+
+  JammerHelper jammerHelper;
+  jammerHelper.SetJammerType ("ns3::ConstantJammer");
+  jammerHelper.Set ("ConstantJammerJammingDuration", TimeValue (MilliSeconds (100)));
+  jammerHelper.Set ("ConstantJammerConstantInterval", TimeValue (MilliSeconds (400)));
+  Ptr<Jammer> jammer = jammerHelper.Install (nodes.Get (0)).Get (0);
+
+  // bursts over [0.1, 0.2], [0.6, 0.7], [1.1, 1.2] s and so on
+  Simulator::Schedule (Seconds (0.1), &Jammer::StartJammer, jammer);
+  for (uint32_t i = 1; i <= 3; i++)
+    {
+      Simulator::Schedule (Seconds (i + 0.05), &WirelessModuleUtilityBusyTimeTest::Probe, this);
+    }
+  Simulator::Stop (Seconds (3.5));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_busyFractions.size (), 3, "one probe per interval");
+  for (uint32_t i = 0; i < m_busyFractions.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_busyFractions[i], 0.2, 1e-3, "busy fraction of interval " << i);
+    }
+
+  m_utility = 0;
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the SweepJammerSchedule format: well formed schedules with
+ * and without defaults, and malformed channel:dwell:power entries, which
+ * must be rejected instead of turning into channel 0 or aborting in Time.
+ */
+class SweepJammerScheduleTest : public TestCase
+{
+public:
+  SweepJammerScheduleTest ();
+
+private:
+  void DoRun (void);
+};
+
+SweepJammerScheduleTest::SweepJammerScheduleTest ()
+  : TestCase ("Test of sweep jammer schedule parsing.")
+{
+}
+
+void
+SweepJammerScheduleTest::DoRun (void)
+{
+  std::vector<SweepJammer::Hop> hops;
+  bool parsed = SweepJammer::ParseSchedule ("1:10ms:0.001  6:20ms 11 3::0", MilliSeconds (5),
+                                            0.002, hops);
+  NS_TEST_ASSERT_MSG_EQ (parsed, true, "well formed schedule");
+  NS_TEST_ASSERT_MSG_EQ (hops.size (), 4, "one hop per entry");
+  uint16_t channels[] = {1, 6, 11, 3};
+  Time dwells[] = {MilliSeconds (10), MilliSeconds (20), MilliSeconds (5), MilliSeconds (5)};
+  double powers[] = {0.001, 0.002, 0.002, 0.0};
+  for (uint32_t i = 0; i < hops.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (hops[i].channel, channels[i], "channel of hop " << i);
+      NS_TEST_ASSERT_MSG_EQ (hops[i].dwell, dwells[i], "dwell time of hop " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (hops[i].power, powers[i], 1e-12, "power of hop " << i);
+    }
+
+  hops.clear ();
+  NS_TEST_ASSERT_MSG_EQ (SweepJammer::ParseSchedule ("2:1.5e3us 4:2", Seconds (1), 0.0, hops),
+                         true, "exponent and unitless dwell times");
+  NS_TEST_ASSERT_MSG_EQ (hops.size (), 2, "both hops parsed");
+  NS_TEST_ASSERT_MSG_EQ (hops[0].dwell, MicroSeconds (1500), "dwell time with exponent");
+  NS_TEST_ASSERT_MSG_EQ (hops[1].dwell, Seconds (2), "dwell time in seconds");
+
+  hops.clear ();
+  NS_TEST_ASSERT_MSG_EQ (SweepJammer::ParseSchedule ("  ", Seconds (1), 0.0, hops), true,
+                         "empty schedule");
+  NS_TEST_ASSERT_MSG_EQ (hops.size (), 0, "no hops in an empty schedule");
+
+  std::string malformed[] = {"x", "6x", "0", "-1", "+6", "70000", ":10ms", "6:abc", "6:10parsecs",
+                             "6:0ms", "6:-5ms", "6:0x10ms", "6:infms", "6:10ms:x",
+                             "6:10ms:-1", "6:10ms:1W", "6:10ms:0.1:7"};
+  for (const std::string &entry : malformed)
+    {
+      hops.clear ();
+      parsed = SweepJammer::ParseSchedule ("1 " + entry + " 11", Seconds (1), 0.001, hops);
+      NS_TEST_ASSERT_MSG_EQ (parsed, false, "malformed entry \"" << entry << "\"");
+      NS_TEST_ASSERT_MSG_EQ (hops.size (), 1, "hops before \"" << entry << "\" kept");
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the sweep jammer on a real NslWifiPhy. The hop active at any
+ * time is checked across the wrap-around of the schedule, and the bursts
+ * sent by the JamHop/SwitchToNextHop event chain are checked to start on the
+ * channel of their hop, one channel switch delay into it, with the PHY
+ * following the schedule through a silent hop.
+ */
+class SweepJammerHopTest : public TestCase
+{
+public:
+  SweepJammerHopTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * \brief PhyTxBegin trace function.
+   * \param packet the jamming signal
+   * \param txPowerW the TX power (W)
+   */
+  void TxBegin (Ptr<const Packet> packet, double txPowerW);
+
+  /**
+   * Records the channel of the PHY.
+   */
+  void Probe (void);
+
+  Ptr<NslWifiPhy> m_phy;               //!< PHY of the jammer
+  std::vector<Time> m_burstTimes;      //!< Start of every burst
+  std::vector<uint16_t> m_burstChannels; //!< Channel of every burst
+  std::vector<uint16_t> m_probes;      //!< Channels seen by Probe
+};
+
+SweepJammerHopTest::SweepJammerHopTest ()
+  : TestCase ("Test of sweep jammer hops and bursts on a NslWifiPhy.")
+{
+}
+
+void
+SweepJammerHopTest::TxBegin (Ptr<const Packet> packet, double txPowerW)
+{
+  m_burstTimes.push_back (Simulator::Now ());
+  m_burstChannels.push_back (m_phy->GetChannelNumber ());
+}
+
+void
+SweepJammerHopTest::Probe (void)
+{
+  m_probes.push_back (m_phy->GetChannelNumber ());
+}
+
+void
+SweepJammerHopTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("DsssRate1Mbps"),
+                                "ControlMode", StringValue ("DsssRate1Mbps"));
+  NslWifiPhyHelper wifiPhy = NslWifiPhyHelper::Default ();
+  wifiPhy.Set ("TxPowerStart", DoubleValue (0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (20));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (2));
+  NslWifiChannelHelper wifiChannel = NslWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Install (nodes);
+
+  // two jammed hops and a silent one, 35 ms per pass
+  JammerHelper jammerHelper;
+  jammerHelper.SetJammerType ("ns3::SweepJammer");
+  jammerHelper.Set ("SweepJammerSchedule", StringValue ("1:10ms 6:20ms 11:5ms:0"));
+  Ptr<SweepJammer> jammer = DynamicCast<SweepJammer> (jammerHelper.Install (nodes.Get (0)).Get (0));
+
+  m_phy = DynamicCast<NslWifiPhy> (DynamicCast<WifiNetDevice> (devices.Get (0))->GetPhy ());
+  m_phy->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&SweepJammerHopTest::TxBegin, this));
+  Time settle = m_phy->GetChannelSwitchDelay ();
+  Time start = Seconds (1);
+  Time period = MilliSeconds (35);
+
+  Simulator::Schedule (start, &Jammer::StartJammer, jammer);
+  // during the silent hop, then after the switch at its end
+  Simulator::Schedule (start + MilliSeconds (32), &SweepJammerHopTest::Probe, this);
+  Simulator::Schedule (start + period + MicroSeconds (1), &SweepJammerHopTest::Probe, this);
+  Simulator::Stop (start + 2 * period + MilliSeconds (5));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetPeriod (), period, "period of the schedule");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetHopIndexAt (start), 0, "first hop at start");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetHopIndexAt (start - Seconds (0.5)), 0, "first hop before start");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetHopIndexAt (start + MilliSeconds (10) - NanoSeconds (1)), 0,
+                         "last instant of the first hop");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetHopIndexAt (start + MilliSeconds (10)), 1, "second hop");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetHopIndexAt (start + MilliSeconds (30)), 2, "silent hop");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetHopIndexAt (start + period - NanoSeconds (1)), 2,
+                         "last instant of the pass");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetHopIndexAt (start + period), 0, "wraps to the first hop");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetHopIndexAt (start + 100 * period + MilliSeconds (12)), 1,
+                         "hop a hundred passes later");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetChannelAt (start + period + MilliSeconds (5)), 1,
+                         "channel after wrapping");
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetChannelAt (start + 3 * period + MilliSeconds (32)), 11,
+                         "channel of the silent hop");
+  NS_TEST_ASSERT_MSG_EQ (jammer->IsJammingAt (6, start + MilliSeconds (15)), true,
+                         "jamming the second hop");
+  NS_TEST_ASSERT_MSG_EQ (jammer->IsJammingAt (1, start + MilliSeconds (15)), false,
+                         "not jamming another channel");
+  NS_TEST_ASSERT_MSG_EQ (jammer->IsJammingAt (11, start + MilliSeconds (32)), false,
+                         "silent hop");
+  NS_TEST_ASSERT_MSG_EQ (jammer->IsJammingAt (1, start + period + settle / 2), false,
+                         "switching back after wrapping");
+  NS_TEST_ASSERT_MSG_EQ (jammer->IsJammingAt (1, start + period + settle), true,
+                         "jamming once switched back");
+
+  // the PHY starts on channel 1, so the first burst needs no switch
+  Time bursts[] = {start, start + MilliSeconds (10) + settle, start + period + settle,
+                   start + period + MilliSeconds (10) + settle, start + 2 * period + settle};
+  uint16_t channels[] = {1, 6, 1, 6, 1};
+  NS_TEST_ASSERT_MSG_EQ (m_burstTimes.size (), 5, "one burst per jammed hop");
+  for (uint32_t i = 0; i < m_burstTimes.size () && i < 5; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_burstTimes[i], bursts[i], "start of burst " << i);
+      NS_TEST_ASSERT_MSG_EQ (m_burstChannels[i], channels[i], "channel of burst " << i);
+      // IsJammingAt allows for the switch into the first hop, the first burst skipped it
+      NS_TEST_ASSERT_MSG_EQ (i == 0 || jammer->IsJammingAt (channels[i], bursts[i]), true,
+                             "burst " << i << " agrees with IsJammingAt");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_probes.size (), 2, "both probes ran");
+  NS_TEST_ASSERT_MSG_EQ (m_probes[0], 11, "switched at the end of the burst");
+  NS_TEST_ASSERT_MSG_EQ (m_probes[1], 1, "switched at the end of the silent hop");
+
+  jammer->StopJammer ();
+  NS_TEST_ASSERT_MSG_EQ (jammer->GetChannelAt (start), 0, "no channel once stopped");
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of the eavesdropper jammer follow modes. The jammer runs on a
+ * WirelessModuleUtility standing in for a PHY with three channels. Traffic is
+ * busy on channel 2, moves to channel 3 and comes back. Without a follow mode
+ * the jammer only keeps its histogram; in reactive and constant mode it must
+ * jam the busiest channel after each scan, move to channel 3 once a rescan
+ * hears it busier, and the traffic decay must let it move back to channel 2.
+ */
+class EavesdropperJammerFollowTest : public TestCase
+{
+public:
+  EavesdropperJammerFollowTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * Runs the scenario in a follow mode.
+   *
+   * \param followMode the EavesdropperJammerFollowMode
+   */
+  void RunFollowMode (uint32_t followMode);
+
+  /**
+   * \brief Channel switch callback of the utility.
+   * \param channel the new channel
+   */
+  void SwitchChannel (uint16_t channel);
+
+  /**
+   * \brief Send signal callback of the utility.
+   * \param powerW the TX power (W)
+   * \param duration the burst duration
+   */
+  void SendSignal (double &powerW, Time duration);
+
+  /**
+   * Sends a packet on the busy channel, every fifth call one on the quiet
+   * channel as well, and schedules the next call 10 ms later.
+   */
+  void Traffic (void);
+
+  /**
+   * \brief Delivers a packet to the jammer if it listens on the channel.
+   * \param channel the channel of the packet
+   */
+  void Hear (uint16_t channel);
+
+  /**
+   * Records the target channel and the traffic histogram.
+   */
+  void Probe (void);
+
+  Ptr<WirelessModuleUtility> m_utility; //!< Utility standing in for the PHY
+  Ptr<EavesdropperJammer> m_jammer;     //!< Jammer under test
+  uint32_t m_ticks;                     //!< Calls of Traffic
+  uint32_t m_bursts;                    //!< Jamming bursts sent
+  uint32_t m_offTarget;                 //!< Bursts off the target channel
+  std::vector<uint16_t> m_targets;      //!< Target channel at each probe
+  std::vector<std::vector<double> > m_traffic; //!< Histogram at each probe
+};
+
+EavesdropperJammerFollowTest::EavesdropperJammerFollowTest ()
+  : TestCase ("Test of eavesdropper jammer follow modes, rescans and traffic decay.")
+{
+}
+
+void
+EavesdropperJammerFollowTest::SwitchChannel (uint16_t channel)
+{
+  WirelessModuleUtility::PhyLayerInfo info = m_utility->GetPhyLayerInfo ();
+  info.currentChannel = channel;
+  m_utility->SetPhyLayerInfo (info);
+}
+
+void
+EavesdropperJammerFollowTest::SendSignal (double &powerW, Time duration)
+{
+  m_bursts++;
+  if (m_utility->GetPhyLayerInfo ().currentChannel != m_jammer->GetTargetChannel ())
+    {
+      m_offTarget++;
+    }
+  Simulator::Schedule (duration, &Jammer::EndTxHandler, m_jammer, Create<Packet> (), powerW);
+}
+
+void
+EavesdropperJammerFollowTest::Hear (uint16_t channel)
+{
+  if (m_utility->GetPhyLayerInfo ().currentChannel != channel)
+    {
+      return;
+    }
+  Ptr<Packet> packet = Create<Packet> (100);
+  // a jammer following the channel does not receive
+  if (m_jammer->StartRxHandler (packet, 1e-9))
+    {
+      m_jammer->EndRxHandler (packet, 1e-9);
+    }
+}
+
+void
+EavesdropperJammerFollowTest::Traffic (void)
+{
+  Time now = Simulator::Now ();
+  uint16_t busy = now >= Seconds (2) && now < Seconds (3) ? 3 : 2;
+  Hear (busy);
+  if (m_ticks++ % 5 == 2)
+    {
+      Hear (busy == 2 ? 3 : 2);
+    }
+  Simulator::Schedule (MilliSeconds (10), &EavesdropperJammerFollowTest::Traffic, this);
+}
+
+void
+EavesdropperJammerFollowTest::Probe (void)
+{
+  m_targets.push_back (m_jammer->GetTargetChannel ());
+  std::vector<double> traffic;
+  for (uint16_t channel = 1; channel <= 3; channel++)
+    {
+      traffic.push_back (m_jammer->GetChannelTraffic (channel));
+    }
+  m_traffic.push_back (traffic);
+}
+
+void
+EavesdropperJammerFollowTest::RunFollowMode (uint32_t followMode)
+{
+  m_ticks = 0;
+  m_bursts = 0;
+  m_offTarget = 0;
+  m_targets.clear ();
+  m_traffic.clear ();
+
+  m_utility = CreateObject<WirelessModuleUtility> ();
+  WirelessModuleUtility::PhyLayerInfo info;
+  info.minTxPowerW = 1e-4;
+  info.maxTxPowerW = 0.1;
+  info.TxGainDb = 0;
+  info.RxGainDb = 0;
+  info.phyRate = 1000000;
+  info.numOfChannels = 3;
+  info.currentChannel = 1;
+  info.channelSwitchDelay = MicroSeconds (250);
+  m_utility->SetPhyLayerInfo (info);
+  m_utility->SetChannelSwitchCallback (MakeCallback (&EavesdropperJammerFollowTest::SwitchChannel, this));
+  m_utility->SetSendSignalCallback (MakeCallback (&EavesdropperJammerFollowTest::SendSignal, this));
+
+  // a scan listens 100 ms on each channel, a rescan follows 1 s of jamming
+  m_jammer = CreateObject<EavesdropperJammer> ();
+  m_jammer->SetAttribute ("EavesdropperJammerScanMode", UintegerValue (1));
+  m_jammer->SetAttribute ("EavesdropperJammerNumOfScanCycle", UintegerValue (1));
+  m_jammer->SetAttribute ("EavesdropperJammerRxTimeout", TimeValue (MilliSeconds (100)));
+  m_jammer->SetAttribute ("EavesdropperJammerFollowMode", UintegerValue (followMode));
+  m_jammer->SetAttribute ("EavesdropperJammerRescanInterval", TimeValue (Seconds (1)));
+  m_jammer->SetAttribute ("EavesdropperJammerTrafficDecay", DoubleValue (0.5));
+  m_jammer->SetUtility (m_utility);
+  Ptr<Node> node = CreateObject<Node> ();
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Install (node);
+  node->AggregateObject (m_jammer);
+
+  // traffic off the scan times: busy on channel 2, on channel 3 from 2 s,
+  // on channel 2 again from 3 s
+  Simulator::Schedule (Seconds (1), &Jammer::StartJammer, m_jammer);
+  Simulator::Schedule (MilliSeconds (1005), &EavesdropperJammerFollowTest::Traffic, this);
+  // after the first scan, during the first rescan and after each rescan
+  Time probes[] = {MilliSeconds (1350), MilliSeconds (2450), MilliSeconds (2650), MilliSeconds (3950)};
+  for (Time probe : probes)
+    {
+      Simulator::Schedule (probe, &EavesdropperJammerFollowTest::Probe, this);
+    }
+  Simulator::Stop (Seconds (4.2));
+  Simulator::Run ();
+  m_jammer->StopJammer ();
+  Simulator::Destroy ();
+}
+
+void
+EavesdropperJammerFollowTest::DoRun (void)
+{
+  RunFollowMode (EavesdropperJammer::FOLLOW_NONE);
+  NS_TEST_ASSERT_MSG_EQ (m_targets.size (), 4, "no follow: all probes ran");
+  for (uint32_t i = 0; i < m_targets.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_targets[i], 0, "no follow: no target at probe " << i);
+      // scanned once, the histogram is kept as is
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_traffic[i][0], 0, 1e-9, "no follow: channel 1 at probe " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_traffic[i][1], 10, 1e-9, "no follow: channel 2 at probe " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_traffic[i][2], 2, 1e-9, "no follow: channel 3 at probe " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_jammer->GetBusiestChannel (), 2, "no follow: busiest channel");
+  NS_TEST_ASSERT_MSG_EQ (m_bursts, 0, "no follow: never jams");
+
+  uint32_t followModes[] = {EavesdropperJammer::FOLLOW_REACTIVE, EavesdropperJammer::FOLLOW_CONSTANT};
+  for (uint32_t followMode : followModes)
+    {
+      RunFollowMode (followMode);
+      // each rescan halves the histogram before adding what it hears, the
+      // probe during the first rescan sees channel 2 scanned and half of 3
+      uint16_t targets[] = {2, 0, 3, 2};
+      double traffic[][3] = {{0, 10, 2}, {0, 7, 6}, {0, 7, 11}, {0, 13.5, 7.5}};
+      NS_TEST_ASSERT_MSG_EQ (m_targets.size (), 4, "mode " << followMode << ": all probes ran");
+      for (uint32_t i = 0; i < m_targets.size () && i < 4; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_targets[i], targets[i], "mode " << followMode << ": target at probe " << i);
+          for (uint32_t c = 0; c < 3; c++)
+            {
+              NS_TEST_ASSERT_MSG_EQ_TOL (m_traffic[i][c], traffic[i][c], 1e-9,
+                                         "mode " << followMode << ": channel " << c + 1 << " at probe " << i);
+            }
+        }
+      NS_TEST_ASSERT_MSG_GT (m_bursts, 0, "mode " << followMode << ": jams the target");
+      NS_TEST_ASSERT_MSG_EQ (m_offTarget, 0, "mode " << followMode << ": only jams the target");
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test suite for the models of the jamming module.
+ */
+class JammingModelTestSuite : public TestSuite
+{
+public:
+  JammingModelTestSuite ();
+};
+
+JammingModelTestSuite::JammingModelTestSuite ()
+  : TestSuite ("jamming-model", UNIT)
+{
+  AddTestCase (new PdrWindowTest, TestCase::QUICK);
+  AddTestCase (new StreamingStatisticTest, TestCase::QUICK);
+  AddTestCase (new ReactiveJammerDecisionTest, TestCase::QUICK);
+  AddTestCase (new JammingCoordinatorTest, TestCase::QUICK);
+  AddTestCase (new NslWifiChannelRangeTest, TestCase::QUICK);
+  AddTestCase (new NslWifiChannelLinkCacheTest, TestCase::QUICK);
+  AddTestCase (new NslWifiChannelBatchDeliveryTest, TestCase::QUICK);
+  AddTestCase (new NslWifiPhyRxFrameTest, TestCase::QUICK);
+  AddTestCase (new WirelessModuleUtilityBusyTimeTest, TestCase::QUICK);
+  AddTestCase (new SweepJammerScheduleTest, TestCase::QUICK);
+  AddTestCase (new SweepJammerHopTest, TestCase::QUICK);
+  AddTestCase (new EavesdropperJammerFollowTest, TestCase::QUICK);
+}
+
+// create an instance of the test suite
+JammingModelTestSuite g_jammingModelTestSuite;
+
+} // namespace ns3